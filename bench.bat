@@ -0,0 +1 @@
+gcc -O2 -std=gnu99 -fgnu89-inline -o snake_bench bench/snake_bench.c
\ No newline at end of file
@@ -0,0 +1,617 @@
+// © 2026 Christopher G Chandler
+// Licensed under the MIT License. See LICENSE file in the project root.
+//
+// Headless host build of the game logic, used as benchmark and fuzz
+// harness for the hot paths without an emulator.
+//
+//   snake_bench [sweep [ticks]]      ticks/second of snake_advance and
+//                                    friends for a range of snake lengths
+//   snake_bench game [frames]        full frames of game_loop/game_events
+//                                    with random input
+//   snake_bench fuzz [frames [seed]] random input with occupancy checks
+//                                    after every frame
+//   snake_bench duel [frames [seed]] the same with two snakes
+//   snake_bench auto [frames [seed]] nobody at the controls, the title
+//                                    times out and the computer plays
+//   snake_bench replay [frames [seed]] the fuzz run, every game that
+//                                    ends is replayed in warp and has
+//                                    to end the same way
+//
+// Built with -DSNAKE_ARENA the checks also compare the screen pages
+// with the arena map. The arena has no computer player for auto.
+#define SNAKE_HOST
+#include "../snake.c"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+static unsigned long bench_rng = 1;
+static int           bench_random_input = 0;
+static byte          bench_players = 1;      // 2 picks the two joystick game
+static bool          bench_replay = false;   // replay every finished game
+static bool          bench_replay_due = false;
+static unsigned long bench_replays = 0, bench_replay_differ = 0;
+
+static unsigned bench_rand(void)
+{
+	bench_rng = bench_rng * 1103515245ul + 12345ul;
+	return (unsigned)(bench_rng >> 16) & 0x7fff;
+}
+
+// Joystick input for the game and fuzz modes: mostly steer greedily
+// towards the heart over free cells, sometimes at random, nothing
+// otherwise. Port 2 (n = 0) steers snake 0, port 1 snake 1.
+void hal_host_input(byte n)
+{
+	static const sbyte dirs[4][2] = { { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 } };
+
+	joyx[n] = joyy[n] = 0;
+	joyb[n] = false;
+
+	if (!bench_random_input)
+		return;
+
+	bool title = !frame_sampling;
+
+	// Tally finished replays, and hold F on the title while the last
+	// game waits for its replay
+	if (bench_replay)
+	{
+		if (replay_verdict != REPLAY_NONE)
+		{
+			bench_replays++;
+			if (replay_verdict != REPLAY_MATCH)
+			{
+				bench_replay_differ++;
+				printf("replay %lu differs\n", bench_replays);
+			}
+			replay_verdict = REPLAY_NONE;
+			bench_replay_due = false;
+		}
+
+		hal_host_keys[2] = title && bench_replay_due ? 0x20 : 0;
+		if (title && bench_replay_due)
+			return;
+	}
+
+	// On the title, which polls the ports itself, only the port that
+	// picks the game gets to press fire
+	if ((title || (TheGame.state != GS_PLAYING && TheGame.state != GS_PAUSED)) && n != bench_players - 1)
+		return;
+
+	Snake * s = snake_state(n);
+	int     best = -1, best_dist = 1 << 30;
+
+	if (!title && TheGame.state == GS_PLAYING && bench_rand() % 8)
+	{
+		int fx = fruit_pos % MAP_W, fy = fruit_pos / MAP_W;
+
+		for (int i = 0; i < 4; i++)
+		{
+			word next = s->head + dirs[i][0] + MAP_W * dirs[i][1];
+			if (next != fruit_pos && occ_blocked(next))
+				continue;
+
+			int dx = next % MAP_W - fx, dy = next / MAP_W - fy;
+			int dist = (dx < 0 ? -dx : dx) + (dy < 0 ? -dy : dy);
+			if (dist < best_dist)
+			{
+				best = i;
+				best_dist = dist;
+			}
+		}
+	}
+	else
+		best = bench_rand() % 5 - 1;
+
+	// Let queued turns play out before steering from the head again
+	if (s->turnCount)
+		joyx[n] = joyy[n] = 0;
+	else if (best >= 0)
+	{
+		joyx[n] = dirs[best][0];
+		joyy[n] = dirs[best][1];
+	}
+
+	// Pause now and then, and leave the title screen
+	joyb[n] = bench_rand() % 200 == 0;
+}
+
+static double bench_now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Direction of a hamiltonian cycle through the playfield: the first
+// column runs up, the rows zig-zag across the others.
+static void cycle_dir(word ofs, sbyte * dx, sbyte * dy)
+{
+	int x = ofs % MAP_W, y = ofs / MAP_W, r = y - FIELD_Y0;
+
+	*dx = 0;
+	*dy = 0;
+
+	if (x == FIELD_X0)
+	{
+		if (y == FIELD_Y0)
+			*dx = 1;
+		else
+			*dy = -1;
+	}
+	else if (!(r & 1))
+	{
+		if (x == FIELD_X0 + FIELD_W - 1)
+			*dy = 1;
+		else
+			*dx = 1;
+	}
+	else
+	{
+		if (x == FIELD_X0 + 1 && r != FIELD_H - 1)
+			*dy = 1;
+		else
+			*dx = -1;
+	}
+}
+
+// Point the snake along the cycle, it never collides that way
+static void bench_steer(Snake * s)
+{
+	sbyte dx, dy;
+	cycle_dir(s->head, &dx, &dy);
+
+	s->dir.x = dx;
+	s->dir.y = dy;
+	s->step = dy ? dy * MAP_W : dx;
+}
+
+static void bench_clear_fruit(void)
+{
+	if (fruit_pos != FRUIT_NONE)
+	{
+		occ_release(fruit_pos);
+		field_put(fruit_pos, ' ', VCOL_BLACK);
+		fruit_pos = FRUIT_NONE;
+	}
+}
+
+// Fresh playfield with a snake of the given length on the cycle and no heart
+static void bench_setup(word length)
+{
+	Snake * s = &snake;
+
+	screen_init();
+	hud_init();
+	occ_init();
+	snake_players = 1;
+	snake_init(0);
+	memset(TheGame.score, 0, sizeof(TheGame.score));
+	fruit_pos = FRUIT_NONE;
+
+	// Grow by feeding a heart right in front of the head
+	while (s->length < length)
+	{
+		bench_steer(s);
+		fruit_pos = s->head + s->step;
+		occ_take(fruit_pos);
+		snake_advance();
+		bench_clear_fruit();
+		draw_flush();
+	}
+}
+
+static void bench_sweep(unsigned long ticks)
+{
+	static const word lengths[] = { 1, 16, 64, 128, 255, 512, 835 };
+	Snake * s = &snake;
+
+	printf("%8s %14s %14s %14s\n", "length", "ticks/s", "flash/s", "fruit/s");
+
+	for (unsigned i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++)
+	{
+		bench_setup(lengths[i]);
+
+		// Movement tick as the game runs it: steer, advance, next delay,
+		// then the frame irq draws the queue
+		double t0 = bench_now();
+		for (unsigned long n = 0; n < ticks; n++)
+		{
+			bench_steer(s);
+			if (snake_advance())
+			{
+				printf("unexpected collision at length %d\n", s->length);
+				exit(1);
+			}
+			TheGame.rate[0] = snake_rate(s->length);
+			game_events();
+			draw_flush();
+		}
+		double t1 = bench_now();
+
+		// Collision flash palette steps
+		unsigned long flashes = ticks / 16;
+		for (unsigned long n = 0; n < flashes; n++)
+			snake_flash(FlashColors[n & 7]);
+		double t2 = bench_now();
+
+		// Heart placement with the board filled by the snake
+		for (unsigned long n = 0; n < ticks; n++)
+		{
+			screen_fruit();
+			bench_clear_fruit();
+		}
+		double t3 = bench_now();
+
+		printf("%8d %14.0f %14.0f %14.0f\n", s->length,
+		       ticks / (t1 - t0), flashes / (t2 - t1), ticks / (t3 - t2));
+	}
+}
+
+// Occupancy must match the snake and heart exactly
+static bool bench_check(void)
+{
+	if (TheGame.state != GS_PLAYING && TheGame.state != GS_PAUSED)
+		return true;
+
+	word blocked = 0;
+	for (byte y = 0; y < FIELD_H; y++)
+		for (byte x = 0; x < FIELD_W; x++)
+			if (occ_blocked(MAP_OFS(FIELD_X0 + x, FIELD_Y0 + y)))
+				blocked++;
+
+	// Walls of the level count as taken, they are drawn right away
+	word expected = fruit_pos != FRUIT_NONE;
+#ifndef SNAKE_ARENA
+	for (byte y = 0; y < FIELD_H; y++)
+		for (byte x = 0; x < FIELD_W; x++)
+			if ((byte)screen_get(FIELD_X0 + x, FIELD_Y0 + y) == PETSCII_BLOCK)
+				expected++;
+#endif
+	for (byte p = 0; p < snake_players; p++)
+		expected += snake_state(p)->length;
+
+	if (blocked != expected || blocked != FIELD_CELLS - occ_count)
+	{
+		printf("occupancy mismatch: blocked %d, snakes+heart+walls %d, free %d\n",
+		       blocked, expected, occ_count);
+		return false;
+	}
+
+	// Selecting a snake only moves it between zero page and snakes[]
+	byte id = snake_id;
+	bool ok = true;
+
+	for (byte p = 0; p < snake_players && ok; p++)
+	{
+		snake_select(p);
+
+		Snake * s = &snake;
+		if (!occ_blocked(s->head))
+		{
+			printf("snake %d head cell not taken\n", p);
+			ok = false;
+			break;
+		}
+
+		// Walking the body steps from the tail end has to arrive at the head
+		word ofs = s->tailEnd;
+		for (word i = 0; i < s->length - 1; i++)
+		{
+			if (!occ_blocked(ofs))
+			{
+				printf("snake %d tail cell %d not taken\n", p, i);
+				ok = false;
+				break;
+			}
+			ofs += LinkStep[snake_link_get((s->tailPos + i) & (SNAKE_RING - 1))];
+		}
+
+		if (ok && ofs != s->head)
+		{
+			printf("snake %d body steps end at %d, head at %d\n", p, ofs, s->head);
+			ok = false;
+		}
+	}
+
+	snake_select(id);
+	return ok;
+}
+
+// The HUD drawn from the events shows the scores and the speed, checked
+// once the frame irq drew the last frame's queue
+static bool bench_check_hud(void)
+{
+	if ((TheGame.state != GS_PLAYING && TheGame.state != GS_PAUSED) || replay_warp)
+		return true;
+
+	for (byte p = 0; p < snake_players; p++)
+	{
+		const byte * sp = ScreenRow[0] + (snake_players > 1 ? 3 + 10 * p : 8);
+		for (byte i = 0; i < SCORE_DIGITS; i++)
+		{
+			byte b = TheGame.score[p][SCORE_BYTES - 1 - i / 2];
+			if (sp[i] != 0x30 + (i & 1 ? b & 0x0F : b >> 4))
+			{
+				printf("HUD score %d is not %02x%02x%02x\n", p, TheGame.score[p][2], TheGame.score[p][1], TheGame.score[p][0]);
+				return false;
+			}
+		}
+	}
+
+	byte speed = snake_current_speed();
+	const byte * sp = ScreenRow[0] + 25;
+	if (sp[0] != (speed >= 100 ? 0x31 : ' ') || sp[1] != 0x30 + speed / 10 % 10 || sp[3] != 0x30 + speed % 10)
+	{
+		printf("HUD speed is not %d\n", speed);
+		return false;
+	}
+	return true;
+}
+
+#ifdef SNAKE_ARENA
+// Both pages have to show the arena map where they cover it, the hidden
+// one as far as it is built
+static bool bench_check_page(const byte * sp, const byte * cp, byte x, byte y, byte rows)
+{
+	for (byte r = 0; r < rows; r++)
+		for (byte c = 0; c < VIEW_COLS; c++)
+		{
+			byte m = x + c < ARENA_W && y + r < ARENA_H ? ArenaMap[MAP_OFS(x + c, y + r)] : CELL_EMPTY;
+			word o = PageRow[r + 1] + c;
+			if (sp[o] != CellChar[m >> 4] || (m != CELL_EMPTY && cp[o] != (m & 0x0F)))
+			{
+				printf("page cell %d,%d of map %d,%d differs\n", c, r, x, y);
+				return false;
+			}
+		}
+
+	return true;
+}
+
+static bool bench_check_view(void)
+{
+	if (TheGame.state == GS_READY || replay_warp)
+		return true;
+
+	return bench_check_page(Screen, ColorRam, view_x, view_y, VIEW_ROWS) &&
+		(build_x == 0xFF || bench_check_page(ScreenPages[screen_front ^ 1], ColorShadow, build_x, build_y, build_rows));
+}
+#endif
+
+// The high score table stays sorted, and once it is saved the file on
+// the host drive loads back as the same table
+static bool bench_check_scores(void)
+{
+	for (byte i = 1; i < HS_ENTRIES; i++)
+		if (bcd_greater(hs_table + i * SCORE_BYTES, hs_table + (i - 1) * SCORE_BYTES))
+		{
+			printf("high score %d above %d\n", i + 1, i);
+			return false;
+		}
+
+	bool saved = hs_loaded && !hs_dirty && hs_step == HS_IDLE;
+	printf("high scores: best %02x%02x%02x, %s\n", hs_table[2], hs_table[1], hs_table[0],
+	       saved ? "saved" : "not saved yet");
+	if (!saved || !hs_any())
+		return true;
+
+	// The file image buffer is free while the disk work is idle
+	hs_pos = 0;
+	if (hal_disk_open(HS_FNUM, 8, 2, HS_FILE_NAME ",S,R"))
+	{
+		hs_pos = hal_disk_read(HS_FNUM, hs_file, HS_FILE_SIZE);
+		hal_disk_close(HS_FNUM);
+	}
+
+	if (!hs_valid() || memcmp(hs_file + 2, hs_table, HS_BYTES))
+	{
+		printf("high score file doesn't load back as the table\n");
+		return false;
+	}
+	return true;
+}
+
+// The title picked the port the bench pressed fire on. Port 1 fire pulls
+// the same line as space, and its stick the lines of R, RETURN and the
+// speed keys.
+static bool bench_check_controls(void)
+{
+	if (TheGame.attract || replay_mode == REPLAY_PLAY)
+		return true;
+
+	if (snake_players != bench_players ||
+	    g_controlMode[0] != CTRL_JOYSTICK ||
+	    (bench_players == 2 && g_controlMode[1] != CTRL_JOYSTICK1))
+	{
+		printf("title started %d players, modes %d %d\n", snake_players, g_controlMode[0], g_controlMode[1]);
+		return false;
+	}
+	return true;
+}
+
+static word bench_hearts;       // stats.hearts when the game started
+
+// The record of the game just over placed a heart at the start and one
+// for every heart eaten, a level change throws its last one away
+static bool bench_check_telemetry(void)
+{
+	if (TheGame.attract || replay_mode == REPLAY_PLAY)
+		return true;
+
+	const TelemetryBlock * t = Telemetry;
+	const TelemetryGame  * g = t->ring + ((t->head - 1) & (TLM_GAMES - 1));
+
+	if (g->spawns != (word)(stats.hearts - bench_hearts + 1))
+	{
+		printf("telemetry placed %d hearts, %d eaten\n", g->spawns, stats.hearts - bench_hearts);
+		return false;
+	}
+	return true;
+}
+
+static int bench_game(unsigned long frames, bool check, byte players, bool input)
+{
+	bench_random_input = input;
+	bench_players = players;
+
+	frame_init();
+	sound_init();
+	select_controls();
+	random_init();
+	game_state(GS_READY);
+
+	if (check && input && !bench_check_controls())
+		return 1;
+	bench_hearts = stats.hearts;
+
+	unsigned long ticks = 0, games = 0, played = 0, logged = 0;
+	word          last_pos[SNAKE_PLAYERS] = { 0 }, longest = 0;
+	GameState     last_state = TheGame.state;
+
+	double t0 = bench_now();
+	for (unsigned long n = 0; n < frames; n++)
+	{
+		frame_next();
+		if (check && !bench_check_hud())
+		{
+			printf("failed after %lu frames\n", n);
+			return 1;
+		}
+#ifdef SNAKE_ARENA
+		if (!replay_warp)
+			arena_scroll();
+		if (check && !bench_check_view())
+		{
+			printf("failed after %lu frames\n", n);
+			return 1;
+		}
+#endif
+		game_loop();
+		game_events();
+
+		// Count ticks by the tail rings moving on, games by their collision
+		for (byte p = 0; p < snake_players; p++)
+		{
+			Snake * s = snake_state(p);
+			if (s->pos != last_pos[p])
+			{
+				ticks++;
+				last_pos[p] = s->pos;
+				if (s->length > longest)
+					longest = s->length;
+			}
+		}
+		if (TheGame.state == GS_COLLIDE && last_state != GS_COLLIDE)
+		{
+			games++;
+			if (!TheGame.attract && replay_mode != REPLAY_PLAY)
+				played++;
+			if (replay_mode != REPLAY_PLAY)
+				logged++;
+			if (bench_replay && replay_mode == REPLAY_RECORD)
+				bench_replay_due = true;
+			if (check && !bench_check_telemetry())
+			{
+				printf("failed after %lu frames\n", n);
+				return 1;
+			}
+		}
+		// A new game from the title
+		if (TheGame.state == GS_READY && last_state == GS_COLLIDE)
+		{
+			if (check && input && !bench_check_controls())
+			{
+				printf("failed after %lu frames\n", n);
+				return 1;
+			}
+			bench_hearts = stats.hearts;
+		}
+		last_state = TheGame.state;
+
+		if (check && !bench_check())
+		{
+			printf("failed after %lu frames\n", n);
+			return 1;
+		}
+	}
+	double t1 = bench_now();
+
+	printf("%lu frames, %lu ticks, %lu games, longest %d, %.0f frames/s\n",
+	       frames, ticks, games, longest, frames / (t1 - t0));
+
+	if (check && !bench_check_scores())
+		return 1;
+
+	// The statistics see every game over the players had
+	printf("stats: %d games, %d hearts, %d levels, %d records\n", stats.games, stats.hearts, stats.levels, stats.records);
+	if (check && stats.games != (word)played)
+	{
+		printf("stats count %d games, the bench %lu\n", stats.games, played);
+		return 1;
+	}
+
+	// Every game but the replays has its telemetry record
+	printf("telemetry: %d games\n", Telemetry->games);
+	if (check && Telemetry->games != (word)logged)
+	{
+		printf("telemetry has %d games, the bench %lu\n", Telemetry->games, logged);
+		return 1;
+	}
+
+	if (bench_replay)
+	{
+		printf("%lu replays, %lu differ\n", bench_replays, bench_replay_differ);
+		return bench_replay_differ != 0;
+	}
+	return 0;
+}
+
+int main(int argc, char ** argv)
+{
+	const char * mode = argc > 1 ? argv[1] : "sweep";
+	unsigned long count = argc > 2 ? strtoul(argv[2], NULL, 0) : 0;
+
+	zp_init();
+	overlay_init();
+	tlm_init();
+#ifndef SNAKE_ARENA
+	ai_init();
+#endif
+
+	// No row selected on the CIA matrix
+	HAL_IO(0xDC00) = 0xFF;
+
+	if (!strcmp(mode, "sweep"))
+		bench_sweep(count ? count : 1000000);
+	else if (!strcmp(mode, "game"))
+		return bench_game(count ? count : 1000000, false, 1, true);
+	else if (!strcmp(mode, "fuzz") || !strcmp(mode, "duel") || !strcmp(mode, "auto") || !strcmp(mode, "replay"))
+	{
+#ifdef SNAKE_ARENA
+		// Nobody would ever leave the title, the arena has no computer player
+		if (!strcmp(mode, "auto"))
+		{
+			printf("auto needs the computer player, the arena build has none\n");
+			return 1;
+		}
+#endif
+		bench_replay = !strcmp(mode, "replay");
+
+		bench_rng = argc > 3 ? strtoul(argv[3], NULL, 0) : 1;
+
+		// random_init() seeds the game from CIA1 timer A
+		HAL_IO(0xDC04) = (byte)bench_rng;
+		HAL_IO(0xDC05) = (byte)(bench_rng >> 8);
+		return bench_game(count ? count : 100000, true, !strcmp(mode, "duel") ? 2 : 1, strcmp(mode, "auto"));
+	}
+	else
+	{
+		printf("usage: snake_bench [sweep|game|fuzz|duel|auto|replay] [count] [seed]\n");
+		return 1;
+	}
+
+	return 0;
+}
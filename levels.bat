@@ -0,0 +1,2 @@
+gcc -O2 -std=gnu99 -fgnu89-inline -o mklevels tools/mklevels.c
+mklevels > snake_levels.h
\ No newline at end of file
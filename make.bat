@@ -1 +1,8 @@
 call oscar64 snake.c
+if errorlevel 1 exit /b 1
+
+rem Crunch with a self extracting decruncher, started from the BASIC SYS line
+exomizer sfx sys -q -o snake_packed.prg snake.prg
+if errorlevel 1 exit /b 1
+
+for %%f in (snake.prg snake_packed.prg) do echo %%~nxf %%~zf bytes
\ No newline at end of file
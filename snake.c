@@ -1,42 +1,56 @@
 // © 2026 Christopher G Chandler
 // Licensed under the MIT License. See LICENSE file in the project root.
-#include <c64/joystick.h>
-#include <c64/vic.h>
-#include <c64/keyboard.h>
-#include <c64/types.h>
-#include <stdlib.h>
+#include "snake_hal.h"
 #include <string.h>
 
 // SID register macros (raw access)
-#define SID_V1_FREQ_LO  (*(volatile byte*)0xD400)
-#define SID_V1_FREQ_HI  (*(volatile byte*)0xD401)
-#define SID_V1_PW_LO    (*(volatile byte*)0xD402)
-#define SID_V1_PW_HI    (*(volatile byte*)0xD403)
-#define SID_V1_CTRL     (*(volatile byte*)0xD404)
-#define SID_V1_AD       (*(volatile byte*)0xD405)
-#define SID_V1_SR       (*(volatile byte*)0xD406)
-
-#define SID_V2_FREQ_LO  (*(volatile byte*)0xD407)
-#define SID_V2_FREQ_HI  (*(volatile byte*)0xD408)
-#define SID_V2_PW_LO    (*(volatile byte*)0xD409)
-#define SID_V2_PW_HI    (*(volatile byte*)0xD40A)
-#define SID_V2_CTRL     (*(volatile byte*)0xD40B)
-#define SID_V2_AD       (*(volatile byte*)0xD40C)
-#define SID_V2_SR       (*(volatile byte*)0xD40D)
-
-#define SID_V3_FREQ_LO  (*(volatile byte*)0xD40E)
-#define SID_V3_FREQ_HI  (*(volatile byte*)0xD40F)
-#define SID_V3_PW_LO    (*(volatile byte*)0xD410)
-#define SID_V3_PW_HI    (*(volatile byte*)0xD411)
-#define SID_V3_CTRL     (*(volatile byte*)0xD412)
-#define SID_V3_AD       (*(volatile byte*)0xD413)
-#define SID_V3_SR       (*(volatile byte*)0xD414)
-
-#define SID_MODE_VOL    (*(volatile byte*)0xD418)
-
-#define CIA1_TA_LO      (*(volatile byte*)0xDC04)
-#define CIA1_TA_HI      (*(volatile byte*)0xDC05)
-#define VIC_RASTER      (*(volatile byte*)0xD012)
+#define SID_V1_FREQ_LO  HAL_IO(0xD400)
+#define SID_V1_FREQ_HI  HAL_IO(0xD401)
+#define SID_V1_PW_LO    HAL_IO(0xD402)
+#define SID_V1_PW_HI    HAL_IO(0xD403)
+#define SID_V1_CTRL     HAL_IO(0xD404)
+#define SID_V1_AD       HAL_IO(0xD405)
+#define SID_V1_SR       HAL_IO(0xD406)
+
+#define SID_V2_FREQ_LO  HAL_IO(0xD407)
+#define SID_V2_FREQ_HI  HAL_IO(0xD408)
+#define SID_V2_PW_LO    HAL_IO(0xD409)
+#define SID_V2_PW_HI    HAL_IO(0xD40A)
+#define SID_V2_CTRL     HAL_IO(0xD40B)
+#define SID_V2_AD       HAL_IO(0xD40C)
+#define SID_V2_SR       HAL_IO(0xD40D)
+
+#define SID_V3_FREQ_LO  HAL_IO(0xD40E)
+#define SID_V3_FREQ_HI  HAL_IO(0xD40F)
+#define SID_V3_PW_LO    HAL_IO(0xD410)
+#define SID_V3_PW_HI    HAL_IO(0xD411)
+#define SID_V3_CTRL     HAL_IO(0xD412)
+#define SID_V3_AD       HAL_IO(0xD413)
+#define SID_V3_SR       HAL_IO(0xD414)
+
+#define SID_MODE_VOL    HAL_IO(0xD418)
+#define SID_V3_OSC      HAL_IO(0xD41B)
+
+#define CIA1_PRA        HAL_IO(0xDC00)
+#define CIA1_PRB        HAL_CIA1_PRB
+#define CIA1_TA_LO      HAL_IO(0xDC04)
+#define CIA1_TA_HI      HAL_IO(0xDC05)
+#define CIA1_ICR        HAL_IO(0xDC0D)
+#define CIA1_CRA        HAL_IO(0xDC0E)
+#define VIC_RASTER      HAL_IO(0xD012)
+#define VIC_MEMPTR      HAL_IO(0xD018)
+#define CIA2_PRA        HAL_IO(0xDD00)
+
+// VIC sprite registers (raw access)
+#define VIC_SPR_X(n)    HAL_IO(0xD000 + 2 * (n))
+#define VIC_SPR_Y(n)    HAL_IO(0xD001 + 2 * (n))
+#define VIC_SPR_MSBX    HAL_IO(0xD010)
+#define VIC_SPR_ENABLE  HAL_IO(0xD015)
+#define VIC_SPR_EXPY    HAL_IO(0xD017)
+#define VIC_SPR_PRIO    HAL_IO(0xD01B)
+#define VIC_SPR_MCOLOR  HAL_IO(0xD01C)
+#define VIC_SPR_EXPX    HAL_IO(0xD01D)
+#define VIC_SPR_COLOR(n) HAL_IO(0xD027 + (n))
 
 
 // Control bits
@@ -53,21 +67,45 @@
 #define PETSCII_HEART   83      // PETSCII code for heart (used for fruit)
 #define PETSCII_BLOCK   160     // PETSCII code for solid block (used for borders)
 
+// Turns buffered between movement ticks, a power of two
+#define TURN_QUEUE_SIZE 4
+
+// With -dSNAKE_EARLY_TURN a turn on a straight run moves the next tick
+// up to at most this many frames away
+#define TURN_EARLY_FRAMES 2
+
+// The body is kept as a ring of 2 bit steps, four to a byte, from the
+// tail end towards the head. 1024 steps cover the whole playfield, in
+// the arena a snake stops growing there.
+#define SNAKE_RING      1024
+
 // Position/Direction on screen
 typedef struct
 {
 	sbyte	x, y;
 } Point;
 
+// Snake state used on every tick, kept in zero page. The ring of body
+// steps is snake_links.
 typedef struct
 {
-	Point	head;		// Position of head
+	word	head;		// Screen offset of head
 	Point	dir;		// Direction of head
-	Point	tail[256];	// Position of tail
-	byte	length;		// Length of tail
-	byte	pos;		// Tail start
+	sbyte	step;		// Field offset delta for dir, +-1 or +-MAP_W
+	Point	turn[TURN_QUEUE_SIZE];	// Turns waiting for the next ticks
+	byte	turnPos;	// Oldest queued turn
+	byte	turnCount;	// Number of queued turns
+	word	tailEnd;	// Screen offset of the last body cell
+	word	tailPos;	// Ring index of the step leaving tailEnd
+	word	pos;		// Ring index of the next step from the head
+	word	length;		// Cells of the snake, head included
+	byte	colHead;	// Color of the head
+	byte	colBody;	// Color of the body
 } Snake;
 
+// One snake, or two on the same board
+#define SNAKE_PLAYERS   2
+
 typedef enum
 {
 	GS_READY,		// Getting ready
@@ -76,61 +114,161 @@ typedef enum
 	GS_PAUSED   	// New 12/04/2025 CC
 } GameState;
 
+#define SCORE_BYTES   3       // packed BCD, lowest two digits first
+#define SCORE_DIGITS  (SCORE_BYTES * 2)
+#define SCORE_HEART   0x01    // BCD points per heart
+
 typedef struct Game
 {
     GameState   state;	
     byte        count;
-    Snake       snake;          // use an array for multiplayer
     byte        pauseButtonPrev;
     byte        pauseFlashCounter;
     byte        pauseVisible;
-    word        score;          // hearts collected
-    word        highScore;      // NEW: best score so far
+    word        move[SNAKE_PLAYERS];     // 8.8 way to the next cell, moves at 1.0
+    byte        rate[SNAKE_PLAYERS];     // 8.8 cells per frame, fraction only
+    byte        next;                    // snake first in line to move
+    byte        crashed;                 // snake that ended the game
+    byte        attract;                 // computer demo game from the title
+    byte        score[SNAKE_PLAYERS][SCORE_BYTES];  // hearts collected, packed BCD
+    byte        highScore[SCORE_BYTES];  // NEW: best score so far, packed BCD
+    byte        level;                   // levels done in this game
+    byte        hearts;                  // hearts collected on this level
 } Game;
 
 Game TheGame;
 
+// What the game running did, for the telemetry ring. Filled in with one
+// add or compare where it happens and copied to the ring at its end.
+typedef struct
+{
+	word	ticks;		// snake moves
+	word	frames;		// frames playing
+	word	paused;		// frames paused
+	word	peak;		// longest snake
+	word	spawns;		// hearts placed
+	word	tries;		// cells the heart placement looked at
+	word	overruns;	// frames the game loop ran late
+	byte	level;		// levels done
+	byte	flags;		// players, TLM_ATTRACT for a demo game
+} TelemetryGame;
+
+static TelemetryGame tlm_game;
+static word          tlm_fruit_tries;   // tries of the heart last placed
+
+// The snake being worked on sits in zero page, the other one is parked
+// in snakes[] and swapped in by snake_select()
+__zeropage Snake snake;
+__zeropage byte  snake_id;
+__zeropage byte * snake_ring;          // snake_links of the snake in zero page
+
+static Snake snakes[SNAKE_PLAYERS];
+static byte  snake_players = 1;        // snakes in this game
+
 typedef enum
 {
-    CTRL_JOYSTICK = 0,
-    CTRL_KEYBOARD = 1
+    CTRL_JOYSTICK = 0,      // joystick in port 2
+    CTRL_KEYBOARD = 1,      // WASD and space
+    CTRL_JOYSTICK1 = 2,     // joystick in port 1
+    CTRL_AI = 3             // computer player, fire or space stops it
 } ControlMode;
 
-static byte g_controlMode = CTRL_JOYSTICK;
+static byte g_controlMode[SNAKE_PLAYERS] = { CTRL_JOYSTICK, CTRL_JOYSTICK1 };
+
+// Two screen pages in VIC bank 2 ($8000-$BFFF) under the banked out
+// BASIC ROM, the VIC still sees the character ROM at $9000 there. A new
+// screen is built on the hidden page and shown by flipping $D018. Color
+// ram can't flip, so the hidden page keeps its colors in a RAM shadow
+// that is copied over right after the flip.
+#define ScreenPage0 HAL_PTR(0xa000)
+#define ScreenPage1 HAL_PTR(0xa400)
+#define ColorRam    HAL_PTR(0xd800)
+
+// Sprite images of the overlay messages, right above the screen pages,
+// and where each page keeps its sprite pointers
+#define OverlaySprites  HAL_PTR(0xa800)
+#define OVERLAY_SPRPTR  0xa0    // (0xa800 - 0x8000) / 64
+#define SPRITE_PTRS     0x3f8
+
+#define VIC_BANK2       0x01    // CIA2 PRA bits 0-1 for $8000-$BFFF
+#define VIC_MEMPTR_P0   0x84    // page at $A000, characters at $9000
+#define VIC_MEMPTR_P1   0x94    // page at $A400, characters at $9000
+
+// Screen offset of a cell, only for constant coordinates
+#define SCREEN_OFS(x, y)	(40 * (y) + (x))
+
+// Row start tables so screen access never multiplies by 40
+#define ROW_TABLE(base) { \
+	base +   0, base +  40, base +  80, base + 120, base + 160, \
+	base + 200, base + 240, base + 280, base + 320, base + 360, \
+	base + 400, base + 440, base + 480, base + 520, base + 560, \
+	base + 600, base + 640, base + 680, base + 720, base + 760, \
+	base + 800, base + 840, base + 880, base + 920, base + 960 }
+
+static byte * const ScreenPages[2] = { ScreenPage0, ScreenPage1 };
+static const byte   ScreenMemPtr[2] = { VIC_MEMPTR_P0, VIC_MEMPTR_P1 };
+
+// Where drawing goes, the visible page or the one being built
+static byte * Screen = ScreenPage0;
+static byte * Color  = ColorRam;
+static byte * ScreenRow[25] = ROW_TABLE(ScreenPage0);
+static byte * ColorRow[25]  = ROW_TABLE(ColorRam);
+
+static byte screen_front = 0;   // visible page
+
+// Snake speed in tenths of a cell per second, the same on PAL and NTSC.
+// 25 is a cell every 20 PAL frames, 125 one every 4.
+#define SPEED_MIN   25
+#define SPEED_MAX   125
 
-// Screen and color ram address
-
-#define Screen ((byte *)0x0400)
-#define Color ((byte *)0xd800)
-
-#define MAX_DELAY_FRAMES 20	
-#define MIN_DELAY_FRAMES 4
-
-#define PAUSE_W  11
-#define PAUSE_H  3
-#define PAUSE_X  ((40 - PAUSE_W) / 2)
-#define PAUSE_Y  ((25 - PAUSE_H) / 2)
 #define PAUSE_FLASH_FRAMES 30
 #define HS_FLASH_INTERVAL 4   // frames between on/off, tweak for faster/slower flash
-#define SPEED_MAX_VALUE   (MAX_DELAY_FRAMES - MIN_DELAY_FRAMES)   // 16 for 20..4
 #define SPEED_CURVE_SCALE 6   // try 2, 3, or 4 to adjust how fast it ramps
 #define COLLIDE_FRAMES 120    // frames to show collision flash
 
-static byte pause_backup_chars[PAUSE_H][PAUSE_W];
-static byte pause_backup_colors[PAUSE_H][PAUSE_W];
-
-static word hud_lastScore = 0xFFFF;
-static byte hud_lastSpeed = 0xFF;
-static word hud_lastHighScore = 0xFFFF;
+#ifdef SNAKE_ARENA
+// The arena map, rows of a power of two cells so a map offset splits
+// into x and y by mask and shift. Camera positions in pixels fit a byte.
+#define ARENA_W      64
+#define ARENA_H      48
+#define ARENA_SHIFT  6
+#define ARENA_CELLS  (ARENA_W * ARENA_H)
+
+// Cells are addressed by map offset, walls all around
+#define MAP_W        ARENA_W
+#define FIELD_X0     1
+#define FIELD_Y0     1
+#define FIELD_W      (ARENA_W - 2)
+#define FIELD_H      (ARENA_H - 2)
+#else
+// Cells are addressed by screen offset. Playfield inside the borders:
+// x 1..38, y 2..23
+#define MAP_W        40
+#define FIELD_X0     1
+#define FIELD_Y0     2
+#define FIELD_W      38
+#define FIELD_H      22
+#endif
+#define FIELD_CELLS  (FIELD_W * FIELD_H)
+
+// Field offset of a cell
+#define MAP_OFS(x, y)	(MAP_W * (y) + (x))
+
+// The body ring caps the length in the arena
+#define SNAKE_MAX_LENGTH (FIELD_CELLS < SNAKE_RING ? FIELD_CELLS : SNAKE_RING)
+#define OCC_BLOCKED  0xFFFF   // occ_slot marker for wall, snake or heart
+#define FRUIT_NONE   0xFFFF   // fruit_pos when the board is full
+
+static byte flash_timer = 0;          // frames until the next collision palette step
+static byte flash_index = 0;          // next FlashColors entry
+
+static bool hud_redraw = false;        // all HUD values to be drawn again
 static byte highScoreFlashCount = 0;   // how many toggles left
 static byte highScoreFlashTimer = 0;   // frames until next toggle
 static byte highScoreFlashOn    = 0;   // 1 when digits visible during flash
 
 
 // Forward declarations
-byte snake_delay_quadratic(byte length);
-byte snake_delay(byte length);
-
 void sound_init(void);
 void sound_step(void);
 void sound_heart(void);
@@ -138,21 +276,237 @@ void sound_update(void);
 void sound_highscore(void);
 void sound_death(void);
 void sound_stop_all(void);
+void screen_show(void);
+void replay_begin(void);
+void hs_game_over(void);
+void tlm_begin(void);
+#ifdef SNAKE_ARENA
+void arena_view_init(void);
+void arena_scroll(void);
+#endif
+
+__zeropage word fruit_pos;	// Field offset of the heart
+
+#ifdef SNAKE_ARENA
+// The arena, one byte per cell: the char in the high nibble, its color in
+// the low one. It is the occupancy as well, every cell that isn't empty
+// is taken, and occ_count only counts the free ones.
+#define CELL(kind, color)   ((kind) << 4 | (color))
+#define CELL_SPACE   0
+#define CELL_BLOCK   1
+#define CELL_CIRCLE  2
+#define CELL_HEART   3
+#define CELL_EMPTY   CELL(CELL_SPACE, VCOL_BLACK)
+#define CELL_WALL    CELL(CELL_BLOCK, VCOL_LT_GREY)
+
+static const byte CellChar[4] = { ' ', PETSCII_BLOCK, PETSCII_CIRCLE, PETSCII_HEART };
+
+static byte ArenaMap[ARENA_CELLS];
+
+void field_put(word ofs, char ch, char color);
+void field_color(word ofs, char color);
+#else
+// Occupancy of the playfield by screen offset. Every free cell is listed
+// in occ_free, occ_slot holds its index there or OCC_BLOCKED. Taking and
+// releasing a cell is a swap-remove/append, so picking a random free cell
+// costs the same however long the snake is.
+static word occ_free[FIELD_CELLS];
+#endif
+__zeropage word occ_count;
+
+// --------------------------
+// Memory map
+//   $0801-$9FFF  program, data and stack, the arena map in -dSNAKE_ARENA
+//   $A000-$A7FF  screen pages, RAM under the banked out BASIC ROM
+//   $A800-$AA3F  overlay message sprites, same
+//   $AC00-$AD1F  telemetry ring, same
+//   $B000-$BFFF  input log of the last game, same
+//   $C000-$CFFF  large tables without initial values (hibss)
+//   zero page    active snake, heart, occupancy count, draw queue count,
+//                random state and sound channels, everything
+//                snake_advance() and sound_update() touch on every tick
+// --------------------------
 
-static byte fruit_x = 0;
-static byte fruit_y = 0;
+#ifndef SNAKE_HOST
+#pragma section( hibss, 0, , , bss )
+#pragma region( hibss, 0xc000, 0xd000, , , { hibss } )
+#pragma bss( hibss )
+#endif
+
+// Rings of snake body steps, page aligned so indexing never crosses a page
+static byte snake_links[SNAKE_PLAYERS][SNAKE_RING / 4];
+
+#ifndef SNAKE_ARENA
+// Occupancy slot by screen offset, see occ_free
+static word occ_slot[1000];
+#endif
+
+// Colors of the screen page being built
+static byte ColorShadow[1000];
+
+#ifndef SNAKE_HOST
+#pragma bss( bss )
+#pragma align( snake_links, 256 )
+#endif
+
+// Point drawing at a screen page and its colors
+void screen_target(byte * scr, byte * col)
+{
+	Screen = scr;
+	Color = col;
+
+	for (byte y = 0; y < 25; y++)
+	{
+		ScreenRow[y] = scr;
+		ColorRow[y] = col;
+		scr += 40;
+		col += 40;
+	}
+}
+
+// Make the other page visible and draw there, only in vblank
+void screen_flip(void)
+{
+	screen_front ^= 1;
+	VIC_MEMPTR = ScreenMemPtr[screen_front];
+	screen_target(ScreenPages[screen_front], ColorRam);
+}
+
+// Select the VIC bank of the screen pages, once at startup
+void screen_pages_init(void)
+{
+	hal_basic_off();
+	CIA2_PRA = (CIA2_PRA & 0xFC) | VIC_BANK2;
+	VIC_MEMPTR = ScreenMemPtr[screen_front];
+}
 
 // Put one  char on screen
 inline void screen_put(byte x, byte y, char ch, char color)
 {
-	Screen[40 * y + x] = ch;
-	Color[40 * y + x] = color;
+	ScreenRow[y][x] = ch;
+	ColorRow[y][x] = color;
 }
 
 // Get one char from screen
 inline char screen_get(byte x, byte y)
 {
-	return Screen[40 * y + x];
+	return ScreenRow[y][x];
+}
+
+// Put one char on screen by screen offset
+inline void screen_put_at(word ofs, char ch, char color)
+{
+	Screen[ofs] = ch;
+	Color[ofs] = color;
+}
+
+// Get one char from screen by screen offset
+inline char screen_get_at(word ofs)
+{
+	return Screen[ofs];
+}
+
+// --------------------------
+// Deferred screen writes
+// Cells changed during gameplay (snake, heart, HUD digits) are queued by
+// the foreground and drained by the frame irq at the start of vblank,
+// so they never land mid-raster.
+// --------------------------
+
+// Entries a frame can queue at most, two players being the worst case:
+//   a move      3 snake cells, 1 heart, 6 score, 4 speed, 6 flash  = 20
+//   GS_READY    the HUD redraw, 2 x 6 score, 4 speed, 6 high score = 22
+//   level up    screen_begin() drops the move's cells, its score and
+//               speed are queued again with the redraw, which draws
+//               the high score or the flash but not both           = 32
+// The arena queues a cell only for the page on show, the page being
+// built gets it directly, so it adds nothing. When the queue is full
+// draw_put() writes to the screen right away; that is a safety net for
+// a bound gone wrong, not part of the fixed cost of a frame.
+#define DRAW_QUEUE_SIZE 32
+
+static word          dq_ofs[DRAW_QUEUE_SIZE];
+static byte          dq_ch[DRAW_QUEUE_SIZE];
+static byte          dq_col[DRAW_QUEUE_SIZE];
+__zeropage byte      dq_count;
+static volatile byte dq_ready = 0;    // 1 when the frame's queue is complete
+
+// Queue one char, falls back to a direct write if the queue is full
+void draw_put(word ofs, char ch, char color)
+{
+	byte i = dq_count;
+	if (i < DRAW_QUEUE_SIZE)
+	{
+		dq_ofs[i] = ofs;
+		dq_ch[i]  = ch;
+		dq_col[i] = color;
+		dq_count = i + 1;
+	}
+	else
+		screen_put_at(ofs, ch, color);
+}
+
+// Drain the queue, called from the frame irq
+void draw_flush(void)
+{
+	for (byte i = 0; i < dq_count; i++)
+	{
+		word ofs = dq_ofs[i];
+		Screen[ofs] = dq_ch[i];
+		Color[ofs]  = dq_col[i];
+	}
+	dq_count = 0;
+}
+
+#ifndef SNAKE_ARENA
+// The playfield is on screen, its cells go through the queue
+inline void field_put(word ofs, char ch, char color)
+{
+	draw_put(ofs, ch, color);
+}
+
+// Recolor a playfield cell right away
+inline void field_color(word ofs, char color)
+{
+	Color[ofs] = color;
+}
+#endif
+
+// --------------------------
+// Game events
+// The game logic posts what happened, the HUD, the sound effects and the
+// play statistics take it from there in game_events() once per frame.
+// Frames without events don't touch the HUD, and a new consumer costs
+// the game logic nothing.
+// --------------------------
+
+typedef enum
+{
+	EV_STEP,        // a snake moved, arg is the snake
+	EV_HEART,       // it ate the heart, its score went up
+	EV_HIGHSCORE,   // and beat the high score
+	EV_SPEED,       // the speed of the longest snake may have changed
+	EV_DEATH,       // a snake crashed, the game is over
+	EV_LEVEL        // enough hearts, on to the next level
+} GameEvent;
+
+// A frame posts at most five, a move with a heart that ends a level
+#define EVENT_QUEUE_SIZE 8
+
+static byte          ev_type[EVENT_QUEUE_SIZE];
+static byte          ev_arg[EVENT_QUEUE_SIZE];
+__zeropage byte      ev_count;
+
+// Post an event for the end of the frame, a full queue drops it
+inline void event_post(byte type, byte arg)
+{
+	byte i = ev_count;
+	if (i < EVENT_QUEUE_SIZE)
+	{
+		ev_type[i] = type;
+		ev_arg[i]  = arg;
+		ev_count = i + 1;
+	}
 }
 
 // PETSCII to screen code helper
@@ -173,192 +527,392 @@ byte petscii_to_screen(char c)
 // Print a PETSCII string to screen
 void screen_print_petscii(byte x, byte y, const char *text, byte color)
 {
+	byte * sp = ScreenRow[y];
+	byte * cp = ColorRow[y];
+
 	while (*text && x < 40)
 	{
 		char c = *text++;
-		byte sc = petscii_to_screen(c);
-		screen_put(x++, y, sc, color);
+		sp[x] = petscii_to_screen(c);
+		cp[x] = color;
+		x++;
 	}
 }
 
-// Draw big 5x5 block text using PETSCII_BLOCK. Characters are drawn
-// with no horizontal gap so up to 8 characters fit across 40 columns.
-static unsigned char get_font_row(char ch, int row)
+// Four hex digits as screen codes, for the debug screens
+void screen_print_hex(byte * sp, word v)
 {
-    switch (ch)
+    static const char hex[] = "0123456789ABCDEF";
+
+    for (signed char i = 3; i >= 0; i--)
     {
-        case 'S':
-            // 11111
-            // 10000
-            // 11111
-            // 00001
-            // 11111
-            return (row==0)?0b11111:(row==1)?0b10000:(row==2)?0b11111:(row==3)?0b00001:0b11111;
-        case 'N':
-            // 10001
-            // 11001
-            // 10101
-            // 10011
-            // 10001
-            return (row==0)?0b10001:(row==1)?0b11001:(row==2)?0b10101:(row==3)?0b10011:0b10001;
-        case 'A':
-            // 01110
-            // 10001
-            // 11111
-            // 10001
-            // 10001
-            return (row==0)?0b01110:(row==1)?0b10001:(row==2)?0b11111:(row==3)?0b10001:0b10001;
-        case 'K':
-            // 10001
-            // 10010
-            // 11100
-            // 10010
-            // 10001
-            return (row==0)?0b10001:(row==1)?0b10010:(row==2)?0b11100:(row==3)?0b10010:0b10001;
-        case 'E':
-            // 11111
-            // 10000
-            // 11110
-            // 10000
-            // 11111
-            return (row==0)?0b11111:(row==1)?0b10000:(row==2)?0b11110:(row==3)?0b10000:0b11111;
-        case '6':
-            // 11111
-            // 10000
-            // 11111
-            // 10001
-            // 11110
-            return (row==0)?0b11111:(row==1)?0b10000:(row==2)?0b11111:(row==3)?0b10001:0b11111;
-        case '4':
-            // 10010
-            // 10010
-            // 11111
-            // 00010
-            // 00010
-            return (row==0)?0b10010:(row==1)?0b10010:(row==2)?0b11111:(row==3)?0b00010:0b00010;
-        case ' ':
-        default:
-            return 0x00;
+        sp[i] = petscii_to_screen(hex[v & 0x0F]);
+        v >>= 4;
     }
 }
 
-static void draw_big_text(byte x0, byte y0, const char *text, char color)
+// 5x5 block font, letters then digits. Each glyph is five rows of five
+// bits, the MSB of the five is the leftmost column.
+#define FONT_GLYPHS  36
+
+static const byte Font5x5[FONT_GLYPHS][5] = {
+	{ 0b01110, 0b10001, 0b11111, 0b10001, 0b10001 },   // A
+	{ 0b11110, 0b10001, 0b11110, 0b10001, 0b11110 },   // B
+	{ 0b01111, 0b10000, 0b10000, 0b10000, 0b01111 },   // C
+	{ 0b11110, 0b10001, 0b10001, 0b10001, 0b11110 },   // D
+	{ 0b11111, 0b10000, 0b11110, 0b10000, 0b11111 },   // E
+	{ 0b11111, 0b10000, 0b11110, 0b10000, 0b10000 },   // F
+	{ 0b01111, 0b10000, 0b10011, 0b10001, 0b01111 },   // G
+	{ 0b10001, 0b10001, 0b11111, 0b10001, 0b10001 },   // H
+	{ 0b11111, 0b00100, 0b00100, 0b00100, 0b11111 },   // I
+	{ 0b00111, 0b00001, 0b00001, 0b10001, 0b01110 },   // J
+	{ 0b10001, 0b10010, 0b11100, 0b10010, 0b10001 },   // K
+	{ 0b10000, 0b10000, 0b10000, 0b10000, 0b11111 },   // L
+	{ 0b10001, 0b11011, 0b10101, 0b10001, 0b10001 },   // M
+	{ 0b10001, 0b11001, 0b10101, 0b10011, 0b10001 },   // N
+	{ 0b01110, 0b10001, 0b10001, 0b10001, 0b01110 },   // O
+	{ 0b11110, 0b10001, 0b11110, 0b10000, 0b10000 },   // P
+	{ 0b01110, 0b10001, 0b10101, 0b10010, 0b01101 },   // Q
+	{ 0b11110, 0b10001, 0b11110, 0b10010, 0b10001 },   // R
+	{ 0b11111, 0b10000, 0b11111, 0b00001, 0b11111 },   // S
+	{ 0b11111, 0b00100, 0b00100, 0b00100, 0b00100 },   // T
+	{ 0b10001, 0b10001, 0b10001, 0b10001, 0b01110 },   // U
+	{ 0b10001, 0b10001, 0b10001, 0b01010, 0b00100 },   // V
+	{ 0b10001, 0b10001, 0b10101, 0b11011, 0b10001 },   // W
+	{ 0b10001, 0b01010, 0b00100, 0b01010, 0b10001 },   // X
+	{ 0b10001, 0b01010, 0b00100, 0b00100, 0b00100 },   // Y
+	{ 0b11111, 0b00010, 0b00100, 0b01000, 0b11111 },   // Z
+	{ 0b01110, 0b10011, 0b10101, 0b11001, 0b01110 },   // 0
+	{ 0b00100, 0b01100, 0b00100, 0b00100, 0b01110 },   // 1
+	{ 0b11110, 0b00001, 0b01110, 0b10000, 0b11111 },   // 2
+	{ 0b11110, 0b00001, 0b01110, 0b00001, 0b11110 },   // 3
+	{ 0b10010, 0b10010, 0b11111, 0b00010, 0b00010 },   // 4
+	{ 0b11111, 0b10000, 0b11110, 0b00001, 0b11110 },   // 5
+	{ 0b11111, 0b10000, 0b11111, 0b10001, 0b11111 },   // 6
+	{ 0b11111, 0b00001, 0b00010, 0b00100, 0b00100 },   // 7
+	{ 0b01110, 0b10001, 0b01110, 0b10001, 0b01110 },   // 8
+	{ 0b11111, 0b10001, 0b11111, 0b00001, 0b11111 },   // 9
+};
+
+// Glyph rows for a character, NULL for a blank
+static const byte * font_glyph(char ch)
 {
-    for (int i = 0; text[i]; i++)
-    {
-        char ch = text[i];
-        for (int row = 0; row < 5; row++)
-        {
-            unsigned char bits = get_font_row(ch, row) & 0x1F; // 5 bits
-            for (int col = 0; col < 5; col++)
-            {
-                if (bits & (1 << (4 - col)))
-                {
-                    /* Add one-column gap between characters by using 6-wide
-                       spacing (5 pixels + 1 blank). */
-                    screen_put((byte)(x0 + i*6 + col), (byte)(y0 + row), PETSCII_BLOCK, color);
-                }
-                else
-                {
-                    // leave existing background (or explicitly clear with space)
-                }
-            }
-        }
-    }
+	if (ch >= 'A' && ch <= 'Z')
+		return Font5x5[ch - 'A'];
+	if (ch >= '0' && ch <= '9')
+		return Font5x5[26 + ch - '0'];
+	return NULL;
 }
 
-// Print a fixed width decimal number at (x,y)
-void screen_print_number(byte x, byte y, word value, byte width, byte color)
+// --------------------------
+// Packed BCD numbers
+// Scores are kept as SCORE_BYTES of packed BCD, lowest byte first, and
+// added in 6502 decimal mode. Printing them is two nibble lookups per
+// byte, no divides.
+// --------------------------
+
+// Binary 0..99 to packed BCD at build time
+#define BCD(n)  ((((n) / 10) << 4) | ((n) % 10))
+
+// Add a two digit packed BCD amount, saturates at all nines
+__noinline void bcd_add(byte * num, byte amount)
 {
-	char buf[5]; // up to 4 digits + null
-	byte i;
+#ifdef SNAKE_HOST
+	// Same digit arithmetic without a decimal mode
+	byte carry = 0;
+	for (byte i = 0; i < SCORE_BYTES; i++)
+	{
+		byte lo = (num[i] & 0x0F) + (amount & 0x0F) + carry;
+		byte hi = (num[i] >> 4) + (amount >> 4);
+		if (lo > 9) { lo -= 10; hi++; }
+		carry = hi > 9;
+		if (carry) hi -= 10;
+		num[i] = (hi << 4) | lo;
+		amount = 0;
+	}
+	if (carry)
+		memset(num, 0x99, SCORE_BYTES);
+#else
+	__asm
+	{
+		php
+		sei             // irq code must not run in decimal mode
+		sed
+		clc
+		ldy #0
+		lda (num), y
+		adc amount
+		sta (num), y
+		ldx #SCORE_BYTES - 1
+	l1:
+		iny
+		lda (num), y
+		adc #0
+		sta (num), y
+		dex
+		bne l1
+		bcc w1
+		lda #$99
+		ldy #SCORE_BYTES - 1
+	l2:
+		sta (num), y
+		dey
+		bpl l2
+	w1:
+		cld
+		plp
+	}
+#endif
+}
 
-	if (width > 4) width = 4;
+// Is BCD number a larger than b
+bool bcd_greater(const byte * a, const byte * b)
+{
+	byte i = SCORE_BYTES;
+	while (i--)
+	{
+		if (a[i] != b[i])
+			return a[i] > b[i];
+	}
+	return false;
+}
 
-	for (i = 0; i < width; i++)
+bool bcd_equal(const byte * a, const byte * b)
+{
+	for (byte i = 0; i < SCORE_BYTES; i++)
 	{
-		buf[width - 1 - i] = '0' + (value % 10);
-		value /= 10;
+		if (a[i] != b[i])
+			return false;
 	}
+	return true;
+}
+
+void bcd_copy(byte * dst, const byte * src)
+{
+	for (byte i = 0; i < SCORE_BYTES; i++)
+		dst[i] = src[i];
+}
+
+// Queue packed BCD bytes at (x,y), highest byte first, two digits per byte
+void draw_print_bcd(byte x, byte y, const byte * num, byte bytes, byte color)
+{
+	word ofs = (word)(ScreenRow[y] - Screen) + x;
 
-	for (i = 0; i < width && x < 40; i++, x++)
+	while (bytes--)
 	{
-		byte sc = petscii_to_screen(buf[i]);
-		screen_put(x, y, sc, color);
+		byte b = num[bytes];
+		draw_put(ofs++, 0x30 + (b >> 4), color);     // screen code of '0' is 0x30
+		draw_put(ofs++, 0x30 + (b & 0x0F), color);
 	}
 }
 
-// Map delay (frames) to speed 1..SPEED_MAX_VALUE
-byte snake_speed_from_delay(byte delay)
+// Queue n blanks at (x,y)
+void draw_blank(byte x, byte y, byte n)
 {
-	byte speed;
+	word ofs = (word)(ScreenRow[y] - Screen) + x;
+
+	while (n--)
+		draw_put(ofs++, ' ', VCOL_BLACK);
+}
+
+// --------------------------
+// Speed curves
+// Speed in tenths of a cell per second for every snake length is
+// generated at build time. Each frame a snake's move accumulator gains
+// its rate in 8.8 cells per frame and the snake moves when it reaches a
+// whole cell, the fraction carries over. The rate is the speed scaled by
+// the frame rate found at boot, so play runs just as fast on NTSC.
+// --------------------------
+
+#define SPEED_CURVE_LINEAR     0
+#define SPEED_CURVE_QUADRATIC  1
+#define SPEED_CURVE_CUSTOM     2
+#define SPEED_CURVE_COUNT      3
+
+// Default curve, override with -dSPEED_CURVE=n, can be changed on the title screen
+#ifndef SPEED_CURVE
+#define SPEED_CURVE SPEED_CURVE_QUADRATIC
+#endif
+
+// Length used by the curves, a length of zero counts as one
+#define CURVE_LEN(len)      ((word)((len) < 1 ? 1 : (len)))
+
+// Linear ramp from SPEED_MIN at length 0 to SPEED_MAX at 255
+#define SPEED_LINEAR(len) \
+	(SPEED_MIN + (CURVE_LEN(len) * (SPEED_MAX - SPEED_MIN)) / 255)
+
+// Quadratic ramp, length is scaled so the "effective" max is reached sooner.
+// Larger SPEED_CURVE_SCALE => faster acceleration
+#define CURVE_X0(len)       ((CURVE_LEN(len) - 1) * SPEED_CURVE_SCALE)
+#define CURVE_X(len)        (CURVE_X0(len) > 255 ? 255 : CURVE_X0(len))
+#define SPEED_QUADRATIC(len) \
+	(SPEED_MIN + ((CURVE_X(len) * CURVE_X(len) / 255) * (SPEED_MAX - SPEED_MIN)) / 255)
+
+// User defined curve, edit to taste. Default reaches full speed after
+// 64 hearts.
+#ifndef SPEED_CUSTOM
+#define SPEED_CUSTOM(len) \
+	(SPEED_MIN + (CURVE_LEN(len) * (SPEED_MAX - SPEED_MIN)) / 64)
+#endif
+
+// Clamp any curve into SPEED_MIN..SPEED_MAX
+#define SPEED_CLAMP(v)      ((v) < SPEED_MIN ? SPEED_MIN : (v) > SPEED_MAX ? SPEED_MAX : (v))
+
+// Expand a macro for every length 0..255
+#define CURVE_4(m, n)    m(n), m(n + 1), m(n + 2), m(n + 3)
+#define CURVE_16(m, n)   CURVE_4(m, n), CURVE_4(m, n + 4), CURVE_4(m, n + 8), CURVE_4(m, n + 12)
+#define CURVE_64(m, n)   CURVE_16(m, n), CURVE_16(m, n + 16), CURVE_16(m, n + 32), CURVE_16(m, n + 48)
+#define CURVE_256(m)     CURVE_64(m, 0), CURVE_64(m, 64), CURVE_64(m, 128), CURVE_64(m, 192)
+
+#define SPEED_LINEAR_C(len)     SPEED_CLAMP(SPEED_LINEAR(len))
+#define SPEED_QUADRATIC_C(len)  SPEED_CLAMP(SPEED_QUADRATIC(len))
+#define SPEED_CUSTOM_C(len)     SPEED_CLAMP(SPEED_CUSTOM(len))
+
+// Speed by curve and snake length
+static const byte SnakeSpeedTab[SPEED_CURVE_COUNT][256] = {
+	{ CURVE_256(SPEED_LINEAR_C) },
+	{ CURVE_256(SPEED_QUADRATIC_C) },
+	{ CURVE_256(SPEED_CUSTOM_C) }
+};
+
+static const char * const SpeedCurveNames[SPEED_CURVE_COUNT] = {
+	"LINEAR   ",
+	"QUADRATIC",
+	"CUSTOM   "
+};
+
+// Speed to 8.8 cells per frame is speed * scale / 256, the scale is
+// 65536 / (10 * frames per second)
+#define SPEED_SCALE_PAL     131     // 50.12 frames per second
+#define SPEED_SCALE_NTSC    110     // 59.83 frames per second
 
-	// Clamp delay to allowed range
-	if (delay <= MIN_DELAY_FRAMES)
-		return SPEED_MAX_VALUE;  // fastest
-	if (delay >= MAX_DELAY_FRAMES)
-		return 1;                // slowest
+// Selected curve
+static byte        speed_curve = SPEED_CURVE;
+static const byte * snake_speed_curve = SnakeSpeedTab[SPEED_CURVE];
+static byte        speed_scale = SPEED_SCALE_PAL;
+static byte        speed_scale_native = SPEED_SCALE_PAL;   // of this machine
+
+void speed_curve_select(byte curve)
+{
+	speed_curve = curve;
+	snake_speed_curve = SnakeSpeedTab[curve];
+}
 
-	speed = MAX_DELAY_FRAMES - delay; // 1..(MAX-MIN)
+// Find the frame rate, once at startup before the frame irq runs
+void speed_init(void)
+{
+	speed_scale_native = hal_video_ntsc() ? SPEED_SCALE_NTSC : SPEED_SCALE_PAL;
+	speed_scale = speed_scale_native;
+}
 
-	if (speed < 1)
-		speed = 1;
-	else if (speed > SPEED_MAX_VALUE)
-		speed = SPEED_MAX_VALUE;
+// Curves are flat from 255 on
+#define SPEED_INDEX(len)    ((len) < 255 ? (byte)(len) : 255)
 
-	return speed;
+// Move rate for a snake length in 8.8 cells per frame, rounded
+inline byte snake_rate(word length)
+{
+	return (byte)(((word)snake_speed_curve[SPEED_INDEX(length)] * speed_scale + 128) >> 8);
 }
 
-// Current speed based on snake length
-byte snake_current_speed(void)
+Snake * snake_state(byte id);
+
+// Current speed based on the longest snake
+inline byte snake_current_speed(void)
 {
-    byte delay = snake_delay(TheGame.snake.length);
-    return snake_speed_from_delay(delay);
+    word length = snake_state(0)->length;
+    if (snake_players > 1 && snake_state(1)->length > length)
+        length = snake_state(1)->length;
+
+    return snake_speed_curve[SPEED_INDEX(length)];
 }
 
 // Draw HUD labels once and reset cached values
 void hud_init(void)
 {
     // Clear row 0 once
-    for (byte x = 0; x < 40; x++)
+    memset(ScreenRow[0], ' ', 40);
+    memset(ColorRow[0], VCOL_BLACK, 40);
+
+    // Score labels, one per player in a two snake game
+    if (snake_players > 1)
     {
-        screen_put(x, 0, ' ', VCOL_BLACK);
+        screen_print_petscii(1, 0, "1:", VCOL_LT_BLUE);     // body colors
+        screen_print_petscii(11, 0, "2:", VCOL_LT_GREEN);
     }
-
-    // Score label
-    screen_print_petscii(1, 0, "SCORE:", VCOL_LT_GREY);
+    else
+        screen_print_petscii(1, 0, "SCORE:", VCOL_LT_GREY);
 
     // Speed label
-    screen_print_petscii(16, 0, "SPD:", VCOL_LT_GREY);
+    screen_print_petscii(21, 0, "SPD:", VCOL_LT_GREY);
 
     // High score label (right aligned block)
-    screen_print_petscii(33, 0, "HI:", VCOL_LT_GREY);
+    screen_print_petscii(30, 0, "HI:", VCOL_LT_GREY);
 
-    // Force first update to draw numbers
-    hud_lastScore     = 0xFFFF;
-    hud_lastSpeed     = 0xFF;
-    hud_lastHighScore = 0xFFFF;
+    // Numbers follow with the first update, on the page shown by then
+    hud_redraw = true;
 
     highScoreFlashCount = 0;
     highScoreFlashTimer = 0;
     highScoreFlashOn    = 0;
 }
 
-// Update HUD numeric values only when they change
-void hud_update(void)
+// Speed as cells per second with one decimal in the 4 cells after SPD:
+void hud_draw_speed(byte speed)
+{
+    byte whole = 0;
+    while (speed >= 10)
+    {
+        speed -= 10;
+        whole++;
+    }
+
+    word ofs = (word)(ScreenRow[0] - Screen) + 25;
+    draw_put(ofs++, whole >= 10 ? 0x31 : ' ', VCOL_WHITE);
+    draw_put(ofs++, 0x30 + (whole >= 10 ? whole - 10 : whole), VCOL_WHITE);
+    draw_put(ofs++, 0x2E, VCOL_WHITE);                  // screen code of '.'
+    draw_put(ofs, 0x30 + speed, VCOL_WHITE);
+}
+
+void hud_draw_score(byte p)
 {
-    byte speed = snake_current_speed();
+    draw_print_bcd(snake_players > 1 ? 3 + 10 * p : 8, 0, TheGame.score[p], SCORE_BYTES, VCOL_WHITE);
+}
 
-    if (TheGame.score != hud_lastScore)
+// HUD consumer of the game events, only scores and speed that changed
+// are drawn
+void hud_event(byte type, byte arg)
+{
+    switch (type)
     {
-        screen_print_number(8, 0, TheGame.score, 3, VCOL_WHITE);
-        hud_lastScore = TheGame.score;
+    case EV_HEART:
+        hud_draw_score(arg);
+        break;
+
+    case EV_SPEED:
+        hud_draw_speed(snake_current_speed());
+        break;
+
+    case EV_HIGHSCORE:
+        // three flashes = six toggles (on/off), the first on the next update
+        highScoreFlashCount = 6;
+        highScoreFlashTimer = 0;
+        highScoreFlashOn    = 1;
+        break;
     }
+}
 
-    if (speed != hud_lastSpeed)
+// The HUD work of frames without events: drawing it all after
+// hud_init() and the high score flash
+void hud_update(void)
+{
+    if (hud_redraw)
     {
-        screen_print_number(21, 0, speed, 2, VCOL_WHITE);
-        hud_lastSpeed = speed;
+        for (byte p = 0; p < snake_players; p++)
+            hud_draw_score(p);
+        hud_draw_speed(snake_current_speed());
+        if (!highScoreFlashCount)
+            draw_print_bcd(33, 0, TheGame.highScore, SCORE_BYTES, VCOL_WHITE);
+        hud_redraw = false;
     }
 
     // High score flashing logic
@@ -379,711 +933,2985 @@ void hud_update(void)
             if (highScoreFlashOn)
             {
                 // show high score digits
-                screen_print_number(36, 0, TheGame.highScore, 3, VCOL_WHITE);
+                draw_print_bcd(33, 0, TheGame.highScore, SCORE_BYTES, VCOL_WHITE);
             }
             else
             {
                 // hide digits by printing spaces
-                screen_print_petscii(36, 0, "   ", VCOL_BLACK);
+                draw_blank(33, 0, SCORE_DIGITS);
             }
         }
     }
-    else
-    {
-        // normal static display when not flashing
-        if (TheGame.highScore != hud_lastHighScore)
-        {
-            screen_print_number(36, 0, TheGame.highScore, 3, VCOL_WHITE);
-            hud_lastHighScore = TheGame.highScore;
-        }
-    }
 }
 
-// Initialize the random number generation using CIA and Current Scan Line
-void random_init(void)
+#ifdef SNAKE_ARENA
+// Walls around the arena, empty inside
+void occ_init(void)
 {
-    // Seed RNG after user interaction so it differs each run
-    {
-        unsigned seed = ((unsigned)CIA1_TA_HI << 8) | CIA1_TA_LO;
-        seed ^= (unsigned)VIC_RASTER;
-        srand(seed);
-    }
+	memset(ArenaMap, CELL_WALL, ARENA_CELLS);
+
+	byte * mp = ArenaMap + MAP_OFS(FIELD_X0, FIELD_Y0);
+	for (byte y = 0; y < FIELD_H; y++)
+	{
+		memset(mp, CELL_EMPTY, FIELD_W);
+		mp += MAP_W;
+	}
+
+	occ_count = FIELD_CELLS;
 }
 
-// Put a fruit/heart at random position
-void screen_fruit(void)
+// Is the cell at map offset taken
+inline bool occ_blocked(word ofs)
 {
-    byte x, y;
-    do
-    {       
-		// Draw a random position inside new borders:
-		// x: 1..38, y: 2..23 (since top border is at y=1, bottom at y=24)
-        x = 1 + (rand() % 38);     // 1..38
-        y = 2 + (rand() % 22);     // 2..23
-		// Ensure it is an empty place	
-    } while (screen_get(x, y) != ' ');
-
-	// Put the heart on screen
-    screen_put(x, y, PETSCII_HEART, VCOL_RED);
+	return ArenaMap[ofs] != CELL_EMPTY;
+}
 
-	// Save the heart position
-    fruit_x = x;
-    fruit_y = y;
+// The map changes with field_put(), these only count
+inline void occ_take(word ofs)
+{
+	(void)ofs;
+	occ_count--;
 }
 
-// Clear screen and draw borders (top border now at row 1)
-void screen_init(void)
+inline void occ_release(word ofs)
 {
-	// Fill screen with spaces
-	memset(Screen, ' ', 1000);
+	(void)ofs;
+	occ_count++;
+}
+#else
+// Mark the whole playfield free, everything else blocked
+void occ_init(void)
+{
+	memset(occ_slot, 0xFF, sizeof(occ_slot));
 
-	// Bottom and top row (top at y=1, bottom at y=24)
-	for(byte x=0; x<40; x++)
+	occ_count = 0;
+	for (byte y = 0; y < FIELD_H; y++)
 	{
-		screen_put(x,  1, PETSCII_BLOCK, VCOL_LT_GREY);
-		screen_put(x, 24, PETSCII_BLOCK, VCOL_LT_GREY);
+		word ofs = (word)(ScreenRow[FIELD_Y0 + y] - Screen) + FIELD_X0;
+		for (byte x = 0; x < FIELD_W; x++)
+		{
+			occ_slot[ofs] = occ_count;
+			occ_free[occ_count++] = ofs;
+			ofs++;
+		}
 	}
+}
 
-	// Left and right column, from y=1 to y=24
-	for(byte y=1; y<25; y++)
+// Is the cell at screen offset taken
+inline bool occ_blocked(word ofs)
+{
+	return occ_slot[ofs] == OCC_BLOCKED;
+}
+
+// Take a free cell, moves the last free cell into its slot
+void occ_take(word ofs)
+{
+	word i = occ_slot[ofs];
+	if (i != OCC_BLOCKED)
 	{
-		screen_put( 0,  y, PETSCII_BLOCK, VCOL_LT_GREY);
-		screen_put( 39, y, PETSCII_BLOCK, VCOL_LT_GREY);			
+		word last = occ_free[--occ_count];
+		occ_free[i] = last;
+		occ_slot[last] = i;
+		occ_slot[ofs] = OCC_BLOCKED;
 	}
 }
 
-// Initialize a snake
-void snake_init(Snake * s)
+// Give a cell back to the free list
+void occ_release(word ofs)
 {
-	// Length of tail is one
-	s->length = 1;
-	s->pos = 0;
-
-	// Snake in the center of playfield (inside new borders)
-	s->head.x = 20;
-	s->head.y = 13;   // was 12; this keeps it visually centered between 2..23
-
-	// Starting to the right
-	s->dir.x = 1;
-	s->dir.y = 0;
-
-	// Show head
-	screen_put(s->head.x, s->head.y, PETSCII_CIRCLE, VCOL_WHITE);
+	if (occ_slot[ofs] == OCC_BLOCKED)
+	{
+		occ_slot[ofs] = occ_count;
+		occ_free[occ_count++] = ofs;
+	}
 }
+#endif
 
-bool snake_advance(Snake * s)
-{
-	// Promote head to start of tail
-	s->tail[s->pos] = s->head;
-	s->pos++;
+#ifndef SNAKE_ARENA
+// --------------------------
+// Levels
+// A game starts in the open box and moves on to the next layout after
+// LEVEL_HEARTS hearts, scores stay and the snakes start over. Layouts
+// are kept as runs over the playfield cells row by row, bit 7 set for
+// walls and a zero ending it, the free rest after the last wall isn't
+// stored. level_load() unpacks them onto the page being built and into
+// the occupancy list, so walls are blocked cells like any other and the
+// heart never lands on one.
+// --------------------------
 
-	// step sound on every advance
-	sound_step();
+// Hearts to the next level, 0 stays in the open box
+#ifndef LEVEL_HEARTS
+#define LEVEL_HEARTS    10
+#endif
 
-	screen_put(s->head.x, s->head.y, PETSCII_CIRCLE, VCOL_LT_BLUE);
+#define LEVEL_RUN_WALL  0x80
+#define LEVEL_RUN_MAX   0x7F
 
-	// Advance head
-	s->head.x += s->dir.x;
-	s->head.y += s->dir.y;
+// The layouts, '#' is a wall. The game builds with run length data made
+// from them by tools/mklevels.c, run levels.bat after changing them.
+// The cells the snakes start on and run into first have to stay free.
+#ifdef SNAKE_LEVEL_TOOL
+typedef struct
+{
+	byte            color;          // of the walls
+	const char *    rows[FIELD_H];
+} LevelLayout;
+
+static const LevelLayout LevelLayouts[] = {
+	{ VCOL_LT_GREY, {
+		"                                      ",
+		"                                      ",
+		"                                      ",
+		"                                      ",
+		"                                      ",
+		"                                      ",
+		"                                      ",
+		"                                      ",
+		"                                      ",
+		"                                      ",
+		"                                      ",
+		"                                      ",
+		"                                      ",
+		"                                      ",
+		"                                      ",
+		"                                      ",
+		"                                      ",
+		"                                      ",
+		"                                      ",
+		"                                      ",
+		"                                      ",
+		"                                      " } },
+	{ VCOL_LT_GREY, {
+		"                                      ",
+		"                                      ",
+		"                                      ",
+		"      ##########################      ",
+		"                                      ",
+		"                                      ",
+		"                                      ",
+		"                                      ",
+		"  #                                #  ",
+		"  #                                #  ",
+		"  #                                #  ",
+		"  #                                #  ",
+		"  #                                #  ",
+		"  #                                #  ",
+		"                                      ",
+		"                                      ",
+		"                                      ",
+		"                                      ",
+		"      ##########################      ",
+		"                                      ",
+		"                                      ",
+		"                                      " } },
+	{ VCOL_BROWN, {
+		"                                      ",
+		"                                      ",
+		"    ##     ##     ##     ##     ##    ",
+		"    ##     ##     ##     ##     ##    ",
+		"                                      ",
+		"                                      ",
+		"                                      ",
+		"    ##     ##     ##     ##     ##    ",
+		"    ##     ##     ##     ##     ##    ",
+		"                                      ",
+		"                                      ",
+		"                                      ",
+		"                                      ",
+		"    ##     ##     ##     ##     ##    ",
+		"    ##     ##     ##     ##     ##    ",
+		"                                      ",
+		"                                      ",
+		"                                      ",
+		"    ##     ##     ##     ##     ##    ",
+		"    ##     ##     ##     ##     ##    ",
+		"                                      ",
+		"                                      " } },
+	{ VCOL_PURPLE, {
+		"                                      ",
+		"                                      ",
+		"                                      ",
+		"    #############    #############    ",
+		"    #                            #    ",
+		"    #                            #    ",
+		"    #                            #    ",
+		"    #                            #    ",
+		"    #                            #    ",
+		"                                      ",
+		"                                      ",
+		"                                      ",
+		"                                      ",
+		"    #                            #    ",
+		"    #                            #    ",
+		"    #                            #    ",
+		"    #                            #    ",
+		"    #                            #    ",
+		"    #############    #############    ",
+		"                                      ",
+		"                                      ",
+		"                                      " } }
+};
 
-	// Get character at new head position
-	char ch = screen_get(s->head.x, s->head.y);
+#define LEVEL_LAYOUTS   (sizeof(LevelLayouts) / sizeof(LevelLayouts[0]))
+#endif
 
-	// Draw head
-	screen_put(s->head.x, s->head.y, PETSCII_CIRCLE, VCOL_WHITE);
+#include "snake_levels.h"
 
-	// Clear tail
-	byte tpos = (byte)(s->pos - s->length);
-	screen_put(s->tail[tpos].x, s->tail[tpos].y, ' ', VCOL_BLACK);
+// Level playing, from the number of levels done in this game
+inline byte level_index(void)
+{
+	return TheGame.level % LEVEL_COUNT;
+}
 
-	// Did snake collect the fruit
-    if (ch == PETSCII_HEART)
-    {
-        // Extend tail
-        s->length++;
-        screen_fruit();
+// Walls of a level onto the page screen_init() started, the rest of
+// the playfield is free
+void level_load(byte n)
+{
+	const byte * lp = Levels[n];
+	byte color = *lp++;
 
-        // Increase score (hearts collected)
-        TheGame.score++;
+	occ_init();
 
-        // Update high score and start flash if beaten
-        if (TheGame.score > TheGame.highScore)
-        {
-            TheGame.highScore = TheGame.score;
+	word ofs = MAP_OFS(FIELD_X0, FIELD_Y0);
+	byte x = 0;
+	byte run;
+	while ((run = *lp++))
+	{
+		byte cells = run & LEVEL_RUN_MAX;
+		do
+		{
+			if (run & LEVEL_RUN_WALL)
+			{
+				screen_put_at(ofs, PETSCII_BLOCK, color);
+				occ_take(ofs);
+			}
 
-            // three flashes = six toggles (on/off)
-            highScoreFlashCount = 6;
-            highScoreFlashTimer = 0;    // toggle immediately on next hud_update
-            highScoreFlashOn    = 1;    // start in "on" state
-            hud_lastHighScore   = 0xFFFF; // force redraw logic later
+			ofs++;
+			if (++x == FIELD_W)
+			{
+				x = 0;
+				ofs += MAP_W - FIELD_W;
+			}
+		} while (--cells);
+	}
+}
+#endif
 
-            // New: high score coin sound
-            sound_highscore();
-        }
+// --------------------------
+// Game random numbers
+// 16 bit xorshift with shifts 7, 9 and 8, the shifts by 8 and 9 are
+// byte moves on the 6502. Ranges are reduced by multiply-shift instead
+// of a modulo. Build with -dRNG_SEED=n for the same sequence every game
+// (replays, benchmarks), or -dRNG_SID_NOISE to stir the voice 3 noise
+// oscillator into the seed.
+// --------------------------
 
-        // pickup sound on fruit
-        sound_heart();		
-    }
-	else if (ch != ' ')
-	{
-		// Snake collided with something (wall, body, etc)
-		return true;
-	}
+__zeropage word rng_state;
+static word rng_seed_used = 1;     // seed of the current game
 
-    // Sanity check: ensure there is still a heart at the remembered fruit position.
-    // If something has erased it (and the head is not currently there), spawn a new one.
-    {
-        char c = screen_get(fruit_x, fruit_y);
-        if (c != PETSCII_HEART &&
-            !(s->head.x == fruit_x && s->head.y == fruit_y))
-        {
-            screen_fruit();
-        }
-    }
+void rng_seed(word seed)
+{
+    // All zero is the one state xorshift never leaves
+    if (!seed)
+        seed = 0xACE1;
 
-	return false;
+    rng_state = seed;
+    rng_seed_used = seed;
 }
 
-// flash the snake after collision
-void snake_flash(Snake * s, char c)
+inline word rng_next(void)
 {
-	// Loop over all tail elements
-	for(byte i = 0; i < s->length; i++)
-	{
-		// Set color
-		byte tpos = (byte)(s->pos - i - 1);
-		screen_put(s->tail[tpos].x, s->tail[tpos].y, PETSCII_CIRCLE, c);
-	}
+    word x = rng_state;
+    x ^= x << 7;
+    x ^= x >> 9;
+    x ^= x << 8;
+    rng_state = x;
+    return x;
 }
 
-// Change snake direction based on user input
-void snake_control(Snake * s, sbyte jx, sbyte jy)
+// Uniform 0..n-1, the high word of rng * n
+inline word rng_range(word n)
 {
-	// First change from horizontal to vertical, otherwise
-	// check vertical to horizontal
-	if (s->dir.x && jy)
-	{
-		s->dir.x = 0;
-		s->dir.y = jy;
-	}
-	else if (s->dir.y && jx)
-	{
-		s->dir.y = 0;
-		s->dir.x = jx;
-	}
+    return (word)(((unsigned long)rng_next() * n) >> 16);
 }
 
-byte snake_delay_linear(byte length)
+// Initialize the random number generation using CIA and Current Scan Line
+void random_init(void)
 {
-    if (length == 0) length = 1;        // safety
-    return MAX_DELAY_FRAMES - ((length * (MAX_DELAY_FRAMES - MIN_DELAY_FRAMES)) / 255);
+#ifdef RNG_SEED
+    rng_seed(RNG_SEED);
+#else
+    // Seed RNG after user interaction so it differs each run
+    word seed = ((word)CIA1_TA_HI << 8) | CIA1_TA_LO;
+    seed ^= VIC_RASTER;
+
+#ifdef RNG_SID_NOISE
+    // Voice 3 is idle with its gate off here, run its noise oscillator at
+    // full rate for a moment and fold the output into the seed
+    SID_V3_FREQ_LO = 0xFF;
+    SID_V3_FREQ_HI = 0xFF;
+    SID_V3_CTRL = SID_CTRL_NOISE;
+    for (byte i = 0; i < 8; i++)
+        seed = (seed << 1 | seed >> 15) ^ SID_V3_OSC;
+    SID_V3_CTRL = SID_CTRL_RECT;
+#endif
+
+    rng_seed(seed);
+#endif
 }
 
-byte snake_delay_quadratic(byte length)
+#ifdef SNAKE_ARENA
+#define ARENA_FRUIT_TRIES  16     // random cells tried before taking the next free one
+#endif
+
+// Put a fruit/heart at random position
+void screen_fruit(void)
 {
-    if (length < 1) length = 1;
+	// Board is full, nowhere left for a heart
+	if (!occ_count)
+	{
+		fruit_pos = FRUIT_NONE;
+		return;
+	}
 
-    // Scale length so the "effective" max is reached sooner
-    // Larger SPEED_CURVE_SCALE => faster acceleration
-    word x = (word)(length - 1) * SPEED_CURVE_SCALE;
+	word tries = tlm_game.tries;
 
-    // Clamp to 0..255 for the quadratic math
-    if (x > 255)
-        x = 255;
+#ifdef SNAKE_ARENA
+	// The arena is mostly empty, random cells find a free one quickly.
+	// Crowded, the search goes on from the last try to the next free cell.
+	word ofs;
+	for (byte i = 0; ; i++)
+	{
+		ofs = MAP_OFS(FIELD_X0 + rng_range(FIELD_W), FIELD_Y0 + rng_range(FIELD_H));
+		tlm_game.tries++;
+		if (!occ_blocked(ofs))
+			break;
 
-    // Quadratic scaling: (x² / 255)
-    word quad = (x * x) / 255;
+		if (i == ARENA_FRUIT_TRIES)
+		{
+			while (occ_blocked(ofs))
+			{
+				tlm_game.tries++;
+				if (++ofs == ARENA_CELLS)
+					ofs = 0;
+			}
+			break;
+		}
+	}
+	fruit_pos = ofs;
+#else
+	// Pick one of the free cells, a single draw however full the board is
+	fruit_pos = occ_free[rng_range(occ_count)];
+	tlm_game.tries++;
+#endif
+	tlm_game.spawns++;
+	tlm_fruit_tries = tlm_game.tries - tries;
+	occ_take(fruit_pos);
 
-    byte delay = MAX_DELAY_FRAMES 
-               - ((quad * (MAX_DELAY_FRAMES - MIN_DELAY_FRAMES)) / 255);
+	// Put the heart on screen
+    field_put(fruit_pos, PETSCII_HEART, VCOL_RED);
+}
 
-    if (delay < MIN_DELAY_FRAMES)
-        delay = MIN_DELAY_FRAMES;
+// Start a new screen on the hidden page, it shows with screen_show()
+void screen_begin(void)
+{
+	// Anything still queued was meant for the old screen
+	dq_count = 0;
 
-    return delay;
+	screen_target(ScreenPages[screen_front ^ 1], ColorShadow);
 }
 
-byte snake_delay(byte length)
+// Unpack a run length image, pairs of count and value until a zero count
+void screen_unpack(byte * dst, const byte * src)
 {
-	return snake_delay_quadratic(length);
+	byte n;
+	while ((n = *src++))
+	{
+		byte v = *src++;
+		do {
+			*dst++ = v;
+		} while (--n);
+	}
 }
 
-void game_state(GameState state)
+// Clear screen and draw borders (top border now at row 1), on the hidden
+// page until screen_show()
+void screen_init(void)
 {
-	// Set new state
-	TheGame.state = state;
+	screen_begin();
 
-	switch(state)
+	// Fill screen with spaces
+	memset(Screen, ' ', 1000);
+
+	// Bottom and top row (top at y=1, bottom at y=24)
+	memset(ScreenRow[1],  PETSCII_BLOCK, 40);
+	memset(ColorRow[1],   VCOL_LT_GREY, 40);
+	memset(ScreenRow[24], PETSCII_BLOCK, 40);
+	memset(ColorRow[24],  VCOL_LT_GREY, 40);
+
+	// Left and right column, from y=1 to y=24
+	for(byte y=1; y<25; y++)
+	{
+		byte * sp = ScreenRow[y];
+		byte * cp = ColorRow[y];
+		sp[ 0] = PETSCII_BLOCK; cp[ 0] = VCOL_LT_GREY;
+		sp[39] = PETSCII_BLOCK; cp[39] = VCOL_LT_GREY;
+	}
+}
+
+// Steps by 2 bit code, right, down, left and up
+static const sbyte LinkStep[4] = { 1, MAP_W, -1, -MAP_W };
+
+// Bit position of a ring index inside its byte
+static const byte LinkShift[4] = { 0, 2, 4, 6 };
+
+// Code of a step, bit 1 for the negative ones, bit 0 for the vertical
+inline byte snake_link_code(sbyte step)
+{
+	byte c = step < 0 ? 2 : 0;
+	if (step != 1 && step != -1)
+		c |= 1;
+	return c;
+}
+
+inline void snake_link_put(word i, byte code)
+{
+	byte * p = snake_ring + (i >> 2);
+	byte   k = LinkShift[i & 3];
+	*p = (*p & ~(3 << k)) | (code << k);
+}
+
+inline byte snake_link_get(word i)
+{
+	return (snake_ring[i >> 2] >> LinkShift[i & 3]) & 3;
+}
+
+// Swap a snake into zero page
+void snake_select(byte id)
+{
+	if (id != snake_id)
+	{
+		snakes[snake_id] = snake;
+		snake = snakes[id];
+		snake_id = id;
+		snake_ring = snake_links[id];
+	}
+}
+
+// State of a snake wherever it is right now
+Snake * snake_state(byte id)
+{
+	return id == snake_id ? &snake : snakes + id;
+}
+
+typedef struct
+{
+	word	head;		// Field offset of the head
+	sbyte	dx;			// Starting direction, +-1
+	byte	colHead, colBody;
+} SnakeStart;
+
+// Start by number of snakes. Alone the snake is in the center of the
+// playfield (row 13 keeps it visually centered between 2..23), two
+// snakes start apart running in opposite directions.
+static const SnakeStart SnakeStarts[SNAKE_PLAYERS][SNAKE_PLAYERS] = {
+#ifdef SNAKE_ARENA
+	{ { MAP_OFS(32, 24),  1, VCOL_WHITE,  VCOL_LT_BLUE } },
+	{ { MAP_OFS(26, 20),  1, VCOL_WHITE,  VCOL_LT_BLUE },
+	  { MAP_OFS(37, 28), -1, VCOL_YELLOW, VCOL_LT_GREEN } }
+#else
+	{ { MAP_OFS(20, 13),  1, VCOL_WHITE,  VCOL_LT_BLUE } },
+	{ { MAP_OFS(10,  8),  1, VCOL_WHITE,  VCOL_LT_BLUE },
+	  { MAP_OFS(29, 18), -1, VCOL_YELLOW, VCOL_LT_GREEN } }
+#endif
+};
+
+// Initialize a snake, it becomes the one in zero page
+void snake_init(byte id)
+{
+	const SnakeStart * st = &SnakeStarts[snake_players - 1][id];
+
+	snake_select(id);
+
+	// Just the head, no body steps
+	snake.length = 1;
+	snake.pos = 0;
+	snake.tailPos = 0;
+
+	snake.head = st->head;
+	snake.colHead = st->colHead;
+	snake.colBody = st->colBody;
+
+	// Starting to the side
+	snake.dir.x = st->dx;
+	snake.dir.y = 0;
+	snake.step = st->dx;
+
+	// No turns pending
+	snake.turnPos = 0;
+	snake.turnCount = 0;
+
+	snake.tailEnd = snake.head;
+
+	// Show head
+	field_put(snake.head, PETSCII_CIRCLE, snake.colHead);
+	occ_take(snake.head);
+}
+
+bool snake_advance(void)
+{
+	// Take one queued turn per tick
+	if (snake.turnCount)
+	{
+		Point * t = snake.turn + snake.turnPos;
+		snake.dir = *t;
+		snake.step = t->y ? (t->y < 0 ? -MAP_W : MAP_W) : t->x;
+		snake.turnPos = (snake.turnPos + 1) & (TURN_QUEUE_SIZE - 1);
+		snake.turnCount--;
+	}
+
+	// Promote head to start of tail, the step to the new head joins the ring
+	snake_link_put(snake.pos, snake_link_code(snake.step));
+	snake.pos = (snake.pos + 1) & (SNAKE_RING - 1);
+
+	// step sound on every advance
+	event_post(EV_STEP, snake_id);
+
+	field_put(snake.head, PETSCII_CIRCLE, snake.colBody);
+
+	// Advance head, one add of +-1 or +-MAP_W
+	snake.head += snake.step;
+
+	// The heart cell is taken too, so check for it first. The tail end is
+	// still taken at this point, running into it is a collision.
+	bool ate = snake.head == fruit_pos;
+	if (!ate && occ_blocked(snake.head))
+	{
+		// Snake collided with something (wall, body, etc)
+		return true;
+	}
+
+	// Draw head
+	field_put(snake.head, PETSCII_CIRCLE, snake.colHead);
+	if (!ate)
+		occ_take(snake.head);
+
+	// Clear tail, unless the snake grows this tick
+	if (ate && snake.length < SNAKE_MAX_LENGTH)
+	{
+		// Extend tail
+		snake.length++;
+		if (snake_speed_curve[SPEED_INDEX(snake.length)] != snake_speed_curve[SPEED_INDEX(snake.length - 1)])
+			event_post(EV_SPEED, snake_id);
+	}
+	else
+	{
+		// Follow the oldest step to the new tail end
+		field_put(snake.tailEnd, ' ', VCOL_BLACK);
+		occ_release(snake.tailEnd);
+		snake.tailEnd += LinkStep[snake_link_get(snake.tailPos)];
+		snake.tailPos = (snake.tailPos + 1) & (SNAKE_RING - 1);
+	}
+
+	// Did snake collect the fruit
+    if (ate)
+    {
+        screen_fruit();
+
+        // Increase score (hearts collected)
+        bcd_add(TheGame.score[snake_id], SCORE_HEART);
+        TheGame.hearts++;
+
+        // Update high score, the HUD flashes it and a coin sound goes
+        if (!TheGame.attract && bcd_greater(TheGame.score[snake_id], TheGame.highScore))
+        {
+            bcd_copy(TheGame.highScore, TheGame.score[snake_id]);
+            event_post(EV_HIGHSCORE, snake_id);
+        }
+
+        // pickup sound on fruit, new score on the HUD
+        event_post(EV_HEART, snake_id);
+    }
+
+	return false;
+}
+
+// flash the snake after collision, the tail is already drawn as circles
+// so only color ram changes
+void snake_flash(char c)
+{
+	word	ofs = snake.tailEnd;
+	word	i = snake.tailPos;
+	byte	bits = snake_ring[i >> 2] >> LinkShift[i & 3];
+
+	// Walk from the tail end along the steps, one shift per cell
+	for(word n = snake.length; ; )
+	{
+		// Set color
+		field_color(ofs, c);
+		if (!--n)
+			break;
+
+		ofs += LinkStep[bits & 3];
+		bits >>= 2;
+
+		i = (i + 1) & (SNAKE_RING - 1);
+		if (!(i & 3))
+			bits = snake_ring[i >> 2];
+	}
+}
+
+// Queue a turn from user input, checked against the last queued
+// direction so reversals and repeats of a held stick never get in.
+// Returns true for a turn on a straight run, with nothing else queued.
+bool snake_control(sbyte jx, sbyte jy)
+{
+	if (snake.turnCount == TURN_QUEUE_SIZE)
+		return false;
+
+	const Point * last = snake.turnCount ?
+		snake.turn + ((snake.turnPos + snake.turnCount - 1) & (TURN_QUEUE_SIZE - 1)) :
+		&snake.dir;
+
+	Point	d;
+
+	// First change from horizontal to vertical, otherwise
+	// check vertical to horizontal
+	if (last->x && jy)
+	{
+		d.x = 0;
+		d.y = jy;
+	}
+	else if (last->y && jx)
+	{
+		d.y = 0;
+		d.x = jx;
+	}
+	else
+		return false;
+
+	snake.turn[(snake.turnPos + snake.turnCount) & (TURN_QUEUE_SIZE - 1)] = d;
+	snake.turnCount++;
+
+	return snake.turnCount == 1;
+}
+
+#ifndef SNAKE_ARENA
+// --------------------------
+// Computer player
+// Steers a snake for the attract mode and for unattended soak runs. A
+// breadth first search from the heart over the occupancy map gives the
+// free cells their distance to it, a few cells per frame so it never
+// costs a frame. The snake follows a hamiltonian cycle through the
+// playfield and only cuts down the distance field where that can't trap
+// it: the body always lies on the cycle between tail and head, so cells
+// ahead of the head and short of the tail are free to skip. Shortcuts
+// never jump past the heart, every move gets it closer along the cycle,
+// and stop at half the board, after that it runs the cycle to the end.
+// --------------------------
+
+#define AI_FAR             255      // ai_dist of cells the search has not reached
+#define AI_CELLS_PER_FRAME 32       // search steps per frame
+#define AI_CLEAR_ROWS      6        // distance rows cleared per frame
+#define AI_TAIL_ROOM       4        // cycle cells kept free in front of the tail
+#define AI_SHORTCUT_LENGTH (FIELD_CELLS / 2)
+
+static word ai_cycle[1000];         // position on the cycle by screen offset
+static byte ai_dist[1000];          // steps to the heart by screen offset
+static word ai_queue[FIELD_CELLS];  // search frontier
+static word ai_qhead, ai_qtail;
+static byte ai_clear;               // rows left to clear before searching
+static word ai_target = FRUIT_NONE; // heart the search runs from
+
+// Number the cycle: row 0 runs right from column 1, the other rows
+// zig-zag over columns 2..38 and column 1 leads back up
+void ai_init(void)
+{
+	word n = 0;
+
+	for (byte y = 0; y < FIELD_H; y++)
+	{
+		word ofs = (word)(ScreenRow[FIELD_Y0 + y] - Screen);
+
+		if (!y)
+		{
+			for (byte x = FIELD_X0; x < FIELD_X0 + FIELD_W; x++)
+				ai_cycle[ofs + x] = n++;
+		}
+		else if (y & 1)
+		{
+			for (byte x = FIELD_X0 + FIELD_W - 1; x > FIELD_X0; x--)
+				ai_cycle[ofs + x] = n++;
+		}
+		else
+		{
+			for (byte x = FIELD_X0 + 1; x < FIELD_X0 + FIELD_W; x++)
+				ai_cycle[ofs + x] = n++;
+		}
+	}
+
+	for (byte y = FIELD_H - 1; y > 0; y--)
+		ai_cycle[(word)(ScreenRow[FIELD_Y0 + y] - Screen) + FIELD_X0] = n++;
+
+	ai_target = FRUIT_NONE;
+}
+
+// Cells from a to b along the cycle, 0..FIELD_CELLS-1
+inline word ai_ahead(word a, word b)
+{
+	word d = ai_cycle[b] - ai_cycle[a];
+	if (d >= FIELD_CELLS)
+		d += FIELD_CELLS;
+	return d;
+}
+
+// One frame worth of searching, starts over when the heart moved
+void ai_update(void)
+{
+	if (ai_target != fruit_pos)
+	{
+		ai_target = fruit_pos;
+		ai_clear = ai_target != FRUIT_NONE ? FIELD_H : 0;
+		ai_qhead = ai_qtail = 0;
+	}
+
+	if (ai_clear)
+	{
+		for (byte i = 0; i < AI_CLEAR_ROWS && ai_clear; i++)
+		{
+			ai_clear--;
+			memset(ai_dist + (ScreenRow[FIELD_Y0 + ai_clear] - Screen) + FIELD_X0, AI_FAR, FIELD_W);
+		}
+
+		// Cleared, the search starts from the heart
+		if (!ai_clear)
+		{
+			ai_dist[ai_target] = 0;
+			ai_queue[ai_qtail++] = ai_target;
+		}
+		return;
+	}
+
+	for (byte i = 0; i < AI_CELLS_PER_FRAME && ai_qhead != ai_qtail; i++)
+	{
+		word ofs = ai_queue[ai_qhead++];
+		byte d   = ai_dist[ofs];
+
+		// Far away cells all look the same
+		if (d < AI_FAR - 1)
+			d++;
+
+		for (byte k = 0; k < 4; k++)
+		{
+			word n = ofs + LinkStep[k];
+			if (ai_dist[n] == AI_FAR && !occ_blocked(n))
+			{
+				ai_dist[n] = d;
+				ai_queue[ai_qtail++] = n;
+			}
+		}
+	}
+}
+
+// Input for the snake in zero page, decided when no turn is queued.
+// Safe moves are the next cell on the cycle and shortcuts up to the heart
+// that keep the tail room, the one closest to the heart wins and the
+// cycle on a tie.
+// With no safe move, e.g. with another snake in the way, any free cell
+// will do.
+void ai_steer(sbyte * jx, sbyte * jy)
+{
+	*jx = 0;
+	*jy = 0;
+
+	if (snake.turnCount)
+		return;
+
+	word gap = ai_ahead(snake.head, snake.tailEnd);
+	if (!gap)
+		gap = FIELD_CELLS;
+
+	// No shortcuts without a heart to cut towards
+	word reach = 0;
+	if (snake.length < AI_SHORTCUT_LENGTH && fruit_pos != FRUIT_NONE)
+		reach = ai_ahead(snake.head, fruit_pos);
+	if (reach + AI_TAIL_ROOM > gap)
+		reach = gap > AI_TAIL_ROOM ? gap - AI_TAIL_ROOM : 0;
+
+	byte best = 0xFF, best_dist = 0;
+	word best_ahead = 0;
+	bool best_safe = false;
+
+	for (byte k = 0; k < 4; k++)
+	{
+		sbyte step = LinkStep[k];
+		if (step == -snake.step)
+			continue;
+
+		word n = snake.head + step;
+		if (n != fruit_pos && occ_blocked(n))
+			continue;
+
+		word ahead = ai_ahead(snake.head, n);
+		byte dist  = ai_dist[n];
+		bool safe  = ahead == 1 || ahead <= reach;
+
+		if (best == 0xFF ||
+			(safe && !best_safe) ||
+			(safe == best_safe && (dist < best_dist || (dist == best_dist && ahead < best_ahead))))
+		{
+			best = k;
+			best_dist = dist;
+			best_ahead = ahead;
+			best_safe = safe;
+		}
+	}
+
+	if (best == 0xFF || LinkStep[best] == snake.step)
+		return;
+
+	switch (best)
+	{
+	case 0: *jx =  1; break;
+	case 1: *jy =  1; break;
+	case 2: *jx = -1; break;
+	case 3: *jy = -1; break;
+	}
+}
+#endif
+
+// --------------------------
+// Message overlay
+// Short messages float over the playfield as a row of three expanded
+// sprites and never touch screen ram. All of them are rendered once at
+// startup with the big font, so showing one sets the sprite pointers and
+// hiding it or flashing it is a single write to the enable register.
+// --------------------------
+
+typedef enum
+{
+	OVL_READY,
+	OVL_PAUSED,
+	OVL_GAMEOVER,
+	OVL_COUNT
+} OverlayMessage;
+
+#define OVERLAY_SPRITES 3       // per message, 72 pixels across
+#define OVERLAY_MASK    0x07    // sprites 0-2
+#define OVERLAY_X       (24 + (320 - OVERLAY_SPRITES * 48) / 2)
+#define OVERLAY_Y       (50 + (200 - 20) / 2)
+
+static const char * const OverlayText[OVL_COUNT] = {
+	"GET READY", "GAME PAUSED", "GAME OVER"
+};
+
+static const byte OverlayColor[OVL_COUNT] = {
+	VCOL_WHITE, VCOL_YELLOW, VCOL_RED
+};
+
+// 5x5 glyphs 6 pixels apart, every font row two sprite lines high
+static void overlay_render(byte * sp, const char * text)
+{
+	memset(sp, 0, OVERLAY_SPRITES * 64);
+
+	byte x = (OVERLAY_SPRITES * 24 + 1 - 6 * strlen(text)) / 2;
+
+	for (byte i = 0; text[i]; i++)
+	{
+		const byte * glyph = font_glyph(text[i]);
+		if (glyph)
+		{
+			for (byte c = 0; c < 5; c++)
+			{
+				byte   px = x + c;
+				byte * dp = sp + 64 * (px / 24) + (px % 24) / 8;
+				byte   m  = 0x80 >> (px & 7);
+
+				for (byte r = 0; r < 5; r++)
+				{
+					if (glyph[r] & (0x10 >> c))
+					{
+						dp[6 * r]     |= m;
+						dp[6 * r + 3] |= m;
+					}
+				}
+			}
+		}
+		x += 6;
+	}
+}
+
+// Render the messages and place the sprites, once at startup
+void overlay_init(void)
+{
+	VIC_SPR_ENABLE = 0;
+
+	for (byte m = 0; m < OVL_COUNT; m++)
+		overlay_render(OverlaySprites + m * (OVERLAY_SPRITES * 64), OverlayText[m]);
+
+	for (byte i = 0; i < OVERLAY_SPRITES; i++)
+	{
+		VIC_SPR_X(i) = OVERLAY_X + 48 * i;
+		VIC_SPR_Y(i) = OVERLAY_Y;
+	}
+
+	VIC_SPR_MSBX   = 0;
+	VIC_SPR_EXPX   = OVERLAY_MASK;
+	VIC_SPR_EXPY   = OVERLAY_MASK;
+	VIC_SPR_PRIO   = 0;        // in front of the playfield
+	VIC_SPR_MCOLOR = 0;
+}
+
+inline void overlay_visible(bool on)
+{
+	VIC_SPR_ENABLE = on ? OVERLAY_MASK : 0;
+}
+
+// Pick the message, both pages point at it so flips don't matter
+void overlay_select(OverlayMessage msg)
+{
+	byte ptr = OVERLAY_SPRPTR + msg * OVERLAY_SPRITES;
+
+	for (byte i = 0; i < OVERLAY_SPRITES; i++)
+	{
+		ScreenPage0[SPRITE_PTRS + i] = ptr + i;
+		ScreenPage1[SPRITE_PTRS + i] = ptr + i;
+		VIC_SPR_COLOR(i) = OverlayColor[msg];
+	}
+}
+
+void overlay_show(OverlayMessage msg)
+{
+	overlay_select(msg);
+	overlay_visible(true);
+}
+
+void overlay_hide(void)
+{
+	overlay_visible(false);
+}
+
+void game_state(GameState state)
+{
+	// Set new state
+	TheGame.state = state;
+
+	switch(state)
 	{
     case GS_READY:
-        // Clear the screen
+#ifdef SNAKE_ARENA
+        // Empty arena around the start
+        occ_init();
+        arena_view_init();
+#else
+        // Clear the screen, then the walls of the level
         screen_init();
+        level_load(level_index());
+#endif
+        // A new game starts from nothing, a new level keeps the scores
+        if (!TheGame.level)
+            memset(TheGame.score, 0, sizeof(TheGame.score));
+
         // Draw HUD labels on row 0
         hud_init();
+        screen_show();
+#ifdef SNAKE_ARENA
+        arena_scroll();
+#endif
+        overlay_show(OVL_READY);
 
         TheGame.count = 32;
         TheGame.pauseButtonPrev = 0;   // safe reset
         break;
 
 	case GS_PLAYING:
-		// Init the snake
-		snake_init(&TheGame.snake);
+		overlay_hide();
 
-		// Reset score at start of each game
-		TheGame.score = 0;
+		// A new game is recorded, or set up for its replay
+		if (!TheGame.level)
+		{
+			replay_begin();
+			tlm_begin();
+		}
+		TheGame.hearts = 0;
+
+		// The playfield is ready since GS_READY, put the snakes on it
+		for (byte p = 0; p < snake_players; p++)
+		{
+			snake_init(p);
+			TheGame.move[p] = 0;
+			TheGame.rate[p] = snake_rate(snake.length);
+		}
+		TheGame.next = 0;
+		event_post(EV_SPEED, 0);
 
 		// Initial fruit
 		screen_fruit();
-
-		TheGame.count = snake_delay(TheGame.snake.length);
 		break;
 
 	case GS_COLLIDE:
         TheGame.count = COLLIDE_FRAMES;
+
+        // Only the snake that ran into something flashes
+        snake_select(TheGame.crashed);
+
+        // First palette entry goes out on the next frame
+        flash_timer = 0;
+        flash_index = 0;
+
+        overlay_show(OVL_GAMEOVER);
+        event_post(EV_DEATH, TheGame.crashed);
+
+        // Saved while the snake flashes and on the title
+        hs_game_over();
+		break;
+
+	case GS_PAUSED:
+		// Optional: draw something else while paused
+		break;
+	}
+}
+
+// Colors for collision "animation"
+char FlashColors[] = {
+	VCOL_YELLOW,
+	VCOL_WHITE,
+	VCOL_LT_GREY,
+	VCOL_YELLOW,
+	VCOL_ORANGE,
+	VCOL_RED,
+	VCOL_MED_GREY,
+	VCOL_DARK_GREY
+};
+
+#define FLASH_COUNT  (sizeof(FlashColors) / sizeof(FlashColors[0]))
+#define FLASH_STEP   (COLLIDE_FRAMES / FLASH_COUNT)   // frames per palette entry
+
+// The banner flashes by switching the overlay on and off, the playfield
+// underneath stays as it is
+void pause_enter(void)
+{
+	overlay_select(OVL_PAUSED);
+	TheGame.pauseFlashCounter = 0;
+	TheGame.pauseVisible      = 0;
+}
+
+void pause_update(void)
+{
+	// Flash every X frames
+	if (++TheGame.pauseFlashCounter >= PAUSE_FLASH_FRAMES)
+	{
+		TheGame.pauseFlashCounter = 0;
+		TheGame.pauseVisible = !TheGame.pauseVisible;
+		overlay_visible(TheGame.pauseVisible);
+	}
+}
+
+void pause_exit(void)
+{
+	overlay_hide();
+	TheGame.pauseVisible = 0;
+}
+
+// --------------------------
+// Simple SID sound engine
+// Voice 1 - death SFX
+// Voice 2 - step and heart SFX
+// Voice 3 - high score SFX
+//
+// Effects are byte tables played by a small sequencer, one channel per
+// voice. An effect names its voice, priority and envelope, followed by
+// steps of control byte, frequency, frames and a per-frame slide. A
+// trigger only takes over a voice from an effect of lower or equal
+// priority. sound_update() does the same bounded work for each voice,
+// at most one step change per frame.
+// --------------------------
+
+// Effect header and step layout
+#define SFX_HEADER      4     // voice, priority, attack/decay, sustain/release
+#define SFX_STEP        5     // ctrl, freq lo, freq hi, frames, slide
+#define SFX_END         0     // ctrl byte ending an effect, gate goes off
+
+#define SFX_NOTE(ctrl, freq, frames, slide) \
+    (ctrl), (byte)((freq) & 0xFF), (byte)((freq) >> 8), (frames), (byte)(slide)
+
+// Short beep on each step, two mid range pitches taking turns
+static const byte SfxStepLo[] = {
+    1, 1, 0x48, 0x88,
+    SFX_NOTE(SID_CTRL_TRI | SID_CTRL_GATE, 0x0900, 6, 0),   // medium pitch
+    SFX_END
+};
+
+static const byte SfxStepHi[] = {
+    1, 1, 0x48, 0x88,
+    SFX_NOTE(SID_CTRL_TRI | SID_CTRL_GATE, 0x0B00, 6, 0),   // slightly higher
+    SFX_END
+};
+
+// Higher, bright and longer pickup sound
+static const byte SfxHeart[] = {
+    1, 2, 0x48, 0x88,
+    SFX_NOTE(SID_CTRL_TRI | SID_CTRL_GATE, 0x1400, 14, 0),
+    SFX_END
+};
+
+// Simple upward arpeggio for coin style sound
+static const byte SfxHighscore[] = {
+    2, 1, 0x28, 0x88,
+    SFX_NOTE(SID_CTRL_RECT | SID_CTRL_GATE, 0x1800, 3, 0),
+    SFX_NOTE(SID_CTRL_RECT | SID_CTRL_GATE, 0x1C00, 3, 0),
+    SFX_NOTE(SID_CTRL_RECT | SID_CTRL_GATE, 0x2000, 3, 0),
+    SFX_NOTE(SID_CTRL_RECT | SID_CTRL_GATE, 0x2400, 3, 0),
+    SFX_END
+};
+
+// Descending sawtooth, think "waaah" style game over slide
+static const byte SfxDeath[] = {
+    0, 1, 0x28, 0x88,
+    SFX_NOTE(SID_CTRL_SAW | SID_CTRL_GATE, 0x0C00, 24, -0x18),
+    SFX_END
+};
+
+// Channel state by voice, zero page arrays
+__zeropage const byte * sfx_pc[3];     // next step, NULL while idle
+__zeropage word         sfx_freq[3];   // current frequency for slides
+__zeropage sbyte        sfx_slide[3];  // added to freq every frame
+__zeropage byte         sfx_timer[3];  // frames left in the current step
+__zeropage byte         sfx_ctrl[3];   // shadow copy of the control register
+__zeropage byte         sfx_prio[3];   // priority of the playing effect
+
+// Voice register blocks, 7 registers apart
+#define SID_VOICE(v)    HAL_PTR(0xD400 + 7 * (v))
+#define SID_FREQ_LO     0
+#define SID_FREQ_HI     1
+#define SID_PW_LO       2
+#define SID_PW_HI       3
+#define SID_CTRL        4
+#define SID_AD          5
+#define SID_SR          6
+
+static byte * const SidVoice[3] = { SID_VOICE(0), SID_VOICE(1), SID_VOICE(2) };
+
+static byte step_toggle  = 0;
+
+// Hold off the frame irq while the foreground changes state it shares
+#define irq_lock()      hal_irq_disable()
+#define irq_unlock()    hal_irq_enable()
+
+// Start the step at pc on a voice, or end the effect
+static void sfx_enter(byte v, const byte * pc)
+{
+    byte * sid = SidVoice[v];
+
+    if (pc[0] == SFX_END)
+    {
+        // End of effect, gate off, keep waveform bits for the release
+        sfx_ctrl[v] &= (byte)~SID_CTRL_GATE;
+        sid[SID_CTRL] = sfx_ctrl[v];
+        sfx_pc[v] = NULL;
+        return;
+    }
+
+    sfx_ctrl[v]  = pc[0];
+    sfx_freq[v]  = pc[1] | ((word)pc[2] << 8);
+    sfx_timer[v] = pc[3];
+    sfx_slide[v] = (sbyte)pc[4];
+    sfx_pc[v]    = pc + SFX_STEP;
+
+    sid[SID_FREQ_LO] = pc[1];
+    sid[SID_FREQ_HI] = pc[2];
+    sid[SID_CTRL]    = sfx_ctrl[v];
+}
+
+// Trigger an effect, unless its voice plays something more important
+void sfx_play(const byte * fx)
+{
+    byte v = fx[0];
+
+    irq_lock();
+
+    if (!sfx_pc[v] || fx[1] >= sfx_prio[v])
+    {
+        byte * sid = SidVoice[v];
+
+        sfx_prio[v] = fx[1];
+        sid[SID_AD] = fx[2];
+        sid[SID_SR] = fx[3];
+        sfx_enter(v, fx + SFX_HEADER);
+    }
+
+    irq_unlock();
+}
+
+void sound_init(void)
+{
+    // Master volume 15, no filter
+    SID_MODE_VOL = 0x0F;
+
+    // Pulse width is not important for SAW, but set something valid
+    SID_V1_PW_LO = 0x00;
+    SID_V1_PW_HI = 0x08;
+
+    SID_V3_PW_LO = 0x00;       // pulse width around 1/4
+    SID_V3_PW_HI = 0x08;
+
+    // Waveform of each voice, gate off to start
+    sfx_ctrl[0] = SID_CTRL_SAW;
+    sfx_ctrl[1] = SID_CTRL_TRI;
+    sfx_ctrl[2] = SID_CTRL_RECT;
+
+    for (byte v = 0; v < 3; v++)
+    {
+        sfx_pc[v] = NULL;
+        SidVoice[v][SID_CTRL] = sfx_ctrl[v];
+    }
+}
+
+void sound_step(void)
+{
+    sfx_play(step_toggle ? SfxStepHi : SfxStepLo);
+    step_toggle ^= 1;
+}
+
+void sound_heart(void)
+{
+    sfx_play(SfxHeart);
+}
+
+void sound_highscore(void)
+{
+    sfx_play(SfxHighscore);
+}
+
+void sound_death(void)
+{
+    sfx_play(SfxDeath);
+}
+
+// Advance all voices by one frame, called from the frame irq
+void sound_update(void)
+{
+    for (byte v = 0; v < 3; v++)
+    {
+        if (!sfx_pc[v])
+            continue;
+
+        if (sfx_slide[v])
+        {
+            byte * sid = SidVoice[v];
+
+            sfx_freq[v] += sfx_slide[v];
+            sid[SID_FREQ_LO] = (byte)(sfx_freq[v] & 0xFF);
+            sid[SID_FREQ_HI] = (byte)(sfx_freq[v] >> 8);
+        }
+
+        if (!--sfx_timer[v])
+            sfx_enter(v, sfx_pc[v]);
+    }
+}
+
+// Stop any ongoing sounds and turn off SID gates
+void sound_stop_all(void)
+{
+    irq_lock();
+
+    // Turn off gates on all voices
+    for (byte v = 0; v < 3; v++)
+    {
+        sfx_pc[v] = NULL;
+        sfx_ctrl[v] &= (byte)~SID_CTRL_GATE;
+        SidVoice[v][SID_CTRL] = sfx_ctrl[v];
+    }
+
+    // Reset step toggle
+    step_toggle = 0;
+
+    irq_unlock();
+}
+
+// --------------------------
+// Keyboard matrix scanner
+// Reads only the CIA1 matrix rows that hold a bound key instead of the
+// whole keyboard. Rows are selected active low on PRA and the columns
+// come back active low on PRB. A joystick in port 1 pulls PRB lines low,
+// a joystick in port 2 pulls PRA lines low and selects extra rows. Both
+// show up as low columns with no row selected, those columns are masked
+// out and the others still read true, so the keyboard works next to a
+// joystick player. A change of keys counts once it held for KEY_DEBOUNCE
+// more frames.
+// --------------------------
+
+#ifndef KEY_DEBOUNCE
+#define KEY_DEBOUNCE    1
+#endif
+
+typedef enum
+{
+    KEY_UP,
+    KEY_LEFT,
+    KEY_DOWN,
+    KEY_RIGHT,
+    KEY_PAUSE,
+
+    KEY_COUNT
+} KeyFunc;
+
+#define KEY_BIT(k)      (1 << (k))
+
+typedef struct
+{
+    byte    row;        // PRA row select, active low
+    byte    bit;        // PRB column bit
+} KeyBinding;
+
+// Key for each function, bindings on the same row next to each other
+// share one row select
+KeyBinding KeyBindings[KEY_COUNT] = {
+    {0xFD, 0x02},       // W
+    {0xFD, 0x04},       // A
+    {0xFD, 0x20},       // S
+    {0xFB, 0x04},       // D
+    {0x7F, 0x10}        // SPACE
+};
+
+static byte key_state;      // debounced KEY_BIT set
+static byte key_raw;        // last raw scan
+static byte key_hold;       // frames the raw scan still has to hold
+
+byte keys_scan(void)
+{
+    // Nothing selected, any low column belongs to a joystick
+    CIA1_PRA = 0xFF;
+    byte usable = CIA1_PRB;
+    byte raw = 0, row = 0xFF, cols = 0xFF;
+
+    for (byte i = 0; i < KEY_COUNT; i++)
+    {
+        const KeyBinding * k = KeyBindings + i;
+        if (k->row != row)
+        {
+            row = k->row;
+            CIA1_PRA = row;
+            cols = CIA1_PRB | (byte)~usable;
+        }
+        if (!(cols & k->bit))
+            raw |= KEY_BIT(i);
+    }
+
+    CIA1_PRA = 0xFF;
+
+    if (raw != key_raw)
+    {
+        key_raw = raw;
+        key_hold = KEY_DEBOUNCE;
+    }
+
+    if (key_hold)
+        key_hold--;
+    else
+        key_state = raw;
+
+    return key_state;
+}
+
+// Unified input: fills jx, jy, btn based on selected control mode
+// jx: -1 left, +1 right, 0 none
+// jy: -1 up,  +1 down,  0 none
+// btn: 1 when "button" is pressed, else 0
+void read_input(byte mode, sbyte *jx, sbyte *jy, byte *btn)
+{
+    *jx = 0;
+    *jy = 0;
+    *btn = 0;
+
+    if (mode == CTRL_AI)
+    {
+        // Steering comes from ai_steer(), either button ends the demo
+        joy_poll(0);
+        *btn = joyb[0] || (keys_scan() & KEY_BIT(KEY_PAUSE)) ? 1 : 0;
+    }
+    else if (mode != CTRL_KEYBOARD)
+    {
+        // joystick, port 2 is joy_poll(0), port 1 is joy_poll(1)
+        byte n = mode == CTRL_JOYSTICK1;
+        joy_poll(n);
+        *jx  = joyx[n];
+        *jy  = joyy[n];
+        *btn = joyb[n] ? 1 : 0;
+    }
+    else
+    {
+        // keyboard only, a few matrix rows
+        byte keys = keys_scan();
+
+        // WASD for direction
+        if (keys & KEY_BIT(KEY_LEFT))       *jx = -1;
+        else if (keys & KEY_BIT(KEY_RIGHT)) *jx =  1;
+
+        if (keys & KEY_BIT(KEY_UP))         *jy = -1;
+        else if (keys & KEY_BIT(KEY_DOWN))  *jy =  1;
+
+        // Space as button
+        if (keys & KEY_BIT(KEY_PAUSE))      *btn = 1;
+    }
+}
+
+// Check for Joystick button
+static int is_fire_pressed(void) {
+    joy_poll(0);                // poll joystick port 2
+    return joyb[0];             // joystick 2 button pressed
+}
+
+// Joystick button in port 1, shares PRB with the keyboard columns
+static int is_fire1_pressed(void) {
+    joy_poll(1);
+    return joyb[1];
+}
+
+// Direct Hardware Scan for one key - doesn't rely on keyb_poll() isn't reliable with joystick
+// row selects the matrix row (active low), bit is the column bit for the key.
+// A column already low with no row selected is the port 1 joystick, as
+// in keys_scan().
+static int is_key_pressed(byte row, byte bit) {
+    CIA1_PRA = 0xFF;
+    byte usable = CIA1_PRB;
+    CIA1_PRA = row;
+    bool down = (usable & bit) && !(CIA1_PRB & bit);
+    CIA1_PRA = 0xFF;
+    return down;
+}
+
+// Direct Hardware Scan for the pause key, space unless rebound
+static int is_space_pressed(void) {
+    return is_key_pressed(KeyBindings[KEY_PAUSE].row, KeyBindings[KEY_PAUSE].bit);
+}
+
+// --------------------------
+// Frame scheduler
+// A raster irq just below the playfield runs sound and input sampling
+// at the same point of every frame. Game logic and HUD run in the
+// foreground and may take longer than a frame without making the audio
+// or input timing jitter; frames they miss are counted as overruns.
+// --------------------------
+
+#define FRAME_IRQ_LINE 250    // first line after the 25 text rows
+
+#ifdef SNAKE_ARENA
+#define ARENA_SPLIT_LINE  59  // first line under the HUD row
+#define ARENA_WINDOW_LINE 67  // first line of the arena window
+#endif
+
+static volatile byte frame_tick      = 0;   // bumped once per frame by the irq
+static byte          frame_last      = 0;   // frame_tick when the current frame started
+static volatile byte frame_sampling  = 0;   // 1 while the irq samples game input
+static word          frame_overruns  = 0;   // frames the foreground started late
+
+// Input latched by the irq for the foreground
+static sbyte input_jx[SNAKE_PLAYERS], input_jy[SNAKE_PLAYERS];
+static byte  input_btn[SNAKE_PLAYERS];
+
+// --------------------------
+// Raster time profiler
+// Build with -dSNAKE_PROFILE. Each subsystem shows a border color bar
+// while it runs and is timed with CIA1 timer A, free running at one
+// count per cycle. Min, average and max over PROF_WINDOW frames are
+// shown on the bottom border row, one subsystem at a time, so the HUD
+// row itself keeps being drawn and measured as usual. Foreground times
+// include any irq that hits them.
+// --------------------------
+
+#define PROF_GAME    0    // game_loop, red bar
+#define PROF_HUD     1    // game_events and hud_update, green bar
+#define PROF_SOUND   2    // sound_update in the irq, blue bar
+#define PROF_FLUSH   3    // draw queue flush in the irq, purple bar
+#define PROF_COUNT   4
+
+#ifdef SNAKE_PROFILE
+
+#define PROF_WINDOW  64   // frames per statistics window, power of two
+#define PROF_ROW     24
+
+static const char * const ProfNames[PROF_COUNT] = {
+    "GAME ", "HUD  ", "SOUND", "FLUSH"
+};
+
+static const byte ProfColors[PROF_COUNT] = {
+    VCOL_RED, VCOL_GREEN, VCOL_BLUE, VCOL_PURPLE
+};
+
+static word          prof_start[PROF_COUNT];
+static byte          prof_border[PROF_COUNT];
+static word          prof_min[PROF_COUNT];
+static word          prof_max[PROF_COUNT];
+static unsigned long prof_sum[PROF_COUNT];
+static byte          prof_frames = 0;
+static byte          prof_show   = 0;     // subsystem on the overlay
+
+// Timer A counts down, read it so the bytes belong together
+static word prof_timer(void)
+{
+    byte hi, lo;
+    do {
+        hi = CIA1_TA_HI;
+        lo = CIA1_TA_LO;
+    } while (hi != CIA1_TA_HI);
+
+    return ((word)hi << 8) | lo;
+}
+
+void prof_reset(void)
+{
+    for (byte i = 0; i < PROF_COUNT; i++)
+    {
+        prof_min[i] = 0xFFFF;
+        prof_max[i] = 0;
+        prof_sum[i] = 0;
+    }
+    prof_frames = 0;
+}
+
+void prof_init(void)
+{
+    // The frame irq replaces the CIA one, so timer A is free to run
+    // the full 16 bits continuously
+    CIA1_ICR = 0x7F;
+    CIA1_TA_LO = 0xFF;
+    CIA1_TA_HI = 0xFF;
+    CIA1_CRA = 0x11;        // force load, continuous, start
+
+    prof_reset();
+}
+
+inline void prof_begin(byte id)
+{
+    prof_border[id] = vic.color_border;
+    vic.color_border = ProfColors[id];
+    prof_start[id] = prof_timer();
+}
+
+inline void prof_end(byte id)
+{
+    word t = prof_start[id] - prof_timer();
+
+    vic.color_border = prof_border[id];
+
+    if (t < prof_min[id]) prof_min[id] = t;
+    if (t > prof_max[id]) prof_max[id] = t;
+    prof_sum[id] += t;
+}
+
+// Close a window every PROF_WINDOW frames and show the next subsystem
+void prof_frame(void)
+{
+    if (++prof_frames < PROF_WINDOW)
+        return;
+
+    byte * sp = ScreenRow[PROF_ROW];
+    byte * cp = ColorRow[PROF_ROW];
+    byte   id = prof_show;
+
+    //          1         2         3
+    // 0123456789012345678901234567890123456789
+    //  GAME  MIN0123 AVG0123 MAX0123 OVR0123
+    screen_print_petscii(1, PROF_ROW, ProfNames[id], VCOL_YELLOW);
+    screen_print_petscii(7, PROF_ROW, "MIN     AVG     MAX     OVR", VCOL_LT_GREY);
+    screen_print_hex(sp + 10, prof_min[id]);
+    screen_print_hex(sp + 18, (word)(prof_sum[id] / PROF_WINDOW));
+    screen_print_hex(sp + 26, prof_max[id]);
+    screen_print_hex(sp + 34, frame_overruns);
+    memset(cp + 10, VCOL_WHITE, 4);
+    memset(cp + 18, VCOL_WHITE, 4);
+    memset(cp + 26, VCOL_WHITE, 4);
+    memset(cp + 34, VCOL_WHITE, 4);
+
+    if (++prof_show == PROF_COUNT)
+        prof_show = 0;
+
+    prof_reset();
+}
+
+#define PROF_BEGIN(id)  prof_begin(id)
+#define PROF_END(id)    prof_end(id)
+
+#else
+
+#define PROF_BEGIN(id)
+#define PROF_END(id)
+
+#endif
+
+__interrupt void frame_irq(void)
+{
+    // Put the finished frame on screen while the beam is in vblank
+    if (dq_ready)
+    {
+        PROF_BEGIN(PROF_FLUSH);
+        draw_flush();
+        PROF_END(PROF_FLUSH);
+        dq_ready = 0;
+    }
+
+    // Update sound envelopes / gates
+    PROF_BEGIN(PROF_SOUND);
+    sound_update();
+    PROF_END(PROF_SOUND);
+
+    // Sample the selected control device
+    if (frame_sampling)
+        for (byte p = 0; p < snake_players; p++)
+            read_input(g_controlMode[p], input_jx + p, input_jy + p, input_btn + p);
+
+    frame_tick++;
+}
+
+void frame_init(void)
+{
+    hal_frame_irq_start(FRAME_IRQ_LINE);
+#ifdef SNAKE_ARENA
+    hal_scroll_start(ARENA_SPLIT_LINE, ARENA_WINDOW_LINE);
+#endif
+}
+
+// Finish the frame: hand the draw queue to the irq and wait until it is
+// drained, which also marks the start of the next frame. If more than one
+// irq went by since the last frame started the foreground was late.
+void frame_wait(void)
+{
+    dq_ready = 1;
+    while (dq_ready)
+        hal_idle();
+
+    byte elapsed = frame_tick - frame_last;
+    if (elapsed > 1)
+        frame_overruns += elapsed - 1;
+
+    frame_last = frame_tick;
+}
+
+// Start counting frames afresh after a long screen transition
+inline void frame_resync(void)
+{
+    frame_last = frame_tick;
+}
+
+// Show the page screen_init() started. Flip in vblank, then copy the
+// shadow colors top row first, which stays ahead of the beam.
+void screen_show(void)
+{
+    frame_wait();
+    screen_flip();
+
+    const byte * cp = ColorShadow;
+    for (byte y = 0; y < 25; y++)
+    {
+        memcpy(ColorRow[y], cp, 40);
+        cp += 40;
+    }
+
+    frame_resync();
+}
+
+#ifdef SNAKE_ARENA
+// --------------------------
+// Scrolling arena
+// Build with -dSNAKE_ARENA. The screen shows a window of the arena map
+// under the HUD row and follows the head of snake 0 with the VIC fine
+// scroll, split off below the HUD by raster irq. A move of the window by
+// a whole cell needs another screen: it is built on the hidden page a
+// few rows per frame ahead of time, for the cell the window is going to
+// reach next, and flipped in when the fine scroll gets there.
+// Cells that change meanwhile are written to both pages. Should the
+// page still be missing the window waits at the edge of the old one.
+// --------------------------
+
+#define VIEW_COLS       40        // map columns on a page
+#define VIEW_ROWS       24        // map rows on a page, screen rows 1..24
+#define WINDOW_W        304       // pixels shown, 38 column mode
+#define WINDOW_H        180       // lines 67..246, 24 row mode
+#define CAM_X_MAX       (ARENA_W * 8 - WINDOW_W)
+#define CAM_Y_MAX       (ARENA_H * 8 - WINDOW_H)
+#define CAM_MARGIN_X    96        // the head stays this far from the edges
+#define CAM_MARGIN_Y    64
+
+#define ARENA_BUILD_ROWS    8     // hidden page rows built per frame
+
+// Playfield scroll registers, the fine scroll goes in bits 0-2
+#define VIEW_CTRL1      0x10      // display on, 24 rows
+#define VIEW_CTRL2      0x00      // 38 columns
+
+static const word PageRow[25] = ROW_TABLE(0);
+
+static byte cam_x, cam_y;             // map pixel at the top left of the window
+static byte view_x, view_y;           // map cell at the top left of the visible page
+static byte build_x = 0xFF, build_y;  // map cell of the hidden page, 0xFF for none
+static byte build_rows;               // rows of it done so far
+
+// Offset on a page starting at map cell x, y for the first rows, or
+// 0xFFFF when the cell isn't there
+static word arena_page_ofs(word ofs, byte x, byte y, byte rows)
+{
+	byte c = (byte)(ofs & (ARENA_W - 1)) - x;
+	byte r = (byte)(ofs >> ARENA_SHIFT) - y;
+
+	return c < VIEW_COLS && r < rows ? PageRow[r + 1] + c : 0xFFFF;
+}
+
+// Put one char of the arena, it shows through the queue if visible
+void field_put(word ofs, char ch, char color)
+{
+	// Compared as bytes, a signed char can't hold PETSCII_BLOCK
+	byte cell = CELL_EMPTY, c = (byte)ch;
+	if (c == PETSCII_BLOCK)
+		cell = CELL(CELL_BLOCK, color);
+	else if (c == PETSCII_CIRCLE)
+		cell = CELL(CELL_CIRCLE, color);
+	else if (c == PETSCII_HEART)
+		cell = CELL(CELL_HEART, color);
+	ArenaMap[ofs] = cell;
+
+	word po = arena_page_ofs(ofs, view_x, view_y, VIEW_ROWS);
+	if (po != 0xFFFF)
+		draw_put(po, ch, color);
+
+	po = arena_page_ofs(ofs, build_x, build_y, build_rows);
+	if (po != 0xFFFF)
+	{
+		ScreenPages[screen_front ^ 1][po] = ch;
+		ColorShadow[po] = color;
+	}
+}
+
+// Recolor one cell of the arena right away
+void field_color(word ofs, char color)
+{
+	ArenaMap[ofs] = (ArenaMap[ofs] & 0xF0) | color;
+
+	word po = arena_page_ofs(ofs, view_x, view_y, VIEW_ROWS);
+	if (po != 0xFFFF)
+		ColorRam[po] = color;
+
+	po = arena_page_ofs(ofs, build_x, build_y, build_rows);
+	if (po != 0xFFFF)
+		ColorShadow[po] = color;
+}
+
+// Next rows of the hidden page, past the edge of the map they stay empty
+static void arena_build(byte rows)
+{
+	byte * page = ScreenPages[screen_front ^ 1];
+
+	for (; rows && build_rows < VIEW_ROWS; rows--)
+	{
+		byte * sp = page + PageRow[build_rows + 1];
+		byte * cp = ColorShadow + PageRow[build_rows + 1];
+		byte   y  = build_y + build_rows;
+		byte   n  = 0;
+
+		if (y < ARENA_H)
+		{
+			const byte * mp = ArenaMap + MAP_OFS(build_x, y);
+
+			n = ARENA_W - build_x < VIEW_COLS ? ARENA_W - build_x : VIEW_COLS;
+			for (byte c = 0; c < n; c++)
+			{
+				byte m = mp[c];
+				sp[c] = CellChar[m >> 4];
+				cp[c] = m & 0x0F;
+			}
+		}
+
+		memset(sp + n, ' ', VIEW_COLS - n);
+		memset(cp + n, VCOL_BLACK, VIEW_COLS - n);
+
+		build_rows++;
+	}
+}
+
+// Start the hidden page over for another map cell
+static void arena_build_start(byte x, byte y)
+{
+	build_x = x;
+	build_y = y;
+	build_rows = 0;
+}
+
+// Show the hidden page in vblank. The HUD row comes along from the old
+// page, then the shadow colors go in top row first, ahead of the beam.
+static void arena_flip(void)
+{
+	byte * old = Screen;
+
+	screen_flip();
+	memcpy(Screen, old, 40);
+
+	const byte * cp = ColorShadow + PageRow[1];
+	for (byte y = 1; y < 25; y++)
+	{
+		memcpy(ColorRow[y], cp, 40);
+		cp += 40;
+	}
+
+	view_x = build_x;
+	view_y = build_y;
+	build_x = 0xFF;
+	build_rows = 0;
+}
+
+// Window position in map pixels that keeps the head cell at pixel p at
+// least margin away from the edges, moving it from cam as little as
+// possible. The head jumps back a few pixels on a turn, the margin
+// takes that up.
+static byte arena_follow(byte cam, sword p, word window, byte margin, byte max)
+{
+	sword c = cam;
+	if (p < c + margin)
+		c = p - margin;
+	else if (p + 8 > c + (sword)(window - margin))
+		c = p + 8 + margin - window;
+
+	return c < 0 ? 0 : c > max ? max : (byte)c;
+}
+
+// Pixels the head has yet to go before the window needs another page on
+// one axis, and to which side. Across the way the head is going it takes
+// a turn first, which counts as a cell more.
+static byte arena_due(byte cam, sword p, sbyte dir, word window, byte margin, sbyte * side)
+{
+	sword lo = p - (cam + margin);
+	sword hi = cam + (sword)(window - margin) - (p + 8);
+	sword d;
+
+	if (dir > 0 || (!dir && hi < lo))
+	{
+		*side = 1;
+		d = hi + 8 - (cam & 7);
+	}
+	else
+	{
+		*side = -1;
+		d = lo + (cam & 7) + 1;
+	}
+	if (!dir)
+		d += 8;
+
+	return d < 0 ? 0 : d < 0xFF ? (byte)d : 0xFE;
+}
+
+// Screen of the empty arena for the first snake's start, on the hidden
+// page until screen_show()
+void arena_view_init(void)
+{
+	word head = SnakeStarts[snake_players - 1][0].head;
+
+	screen_begin();
+
+	// Centred on the head, a window of no margin but half its size
+	cam_x = arena_follow(0, (head & (ARENA_W - 1)) * 8, WINDOW_W, (WINDOW_W - 8) / 2, CAM_X_MAX);
+	cam_y = arena_follow(0, (head >> ARENA_SHIFT) * 8, WINDOW_H, (WINDOW_H - 8) / 2, CAM_Y_MAX);
+	view_x = cam_x >> 3;
+	view_y = cam_y >> 3;
+
+	arena_build_start(view_x, view_y);
+	arena_build(VIEW_ROWS);
+	build_x = 0xFF;
+	build_rows = 0;
+}
+
+// Move the window after the head, once per frame right after the frame
+// wait so a flip and the new scroll values are in before the split. The
+// head is followed by the pixel, partway to its next cell.
+void arena_scroll(void)
+{
+	word  head = SnakeStarts[snake_players - 1][0].head;
+	Point dir = { 0, 0 }, next = { 0, 0 };
+	byte  ahead = 0;
+
+	if (TheGame.state != GS_READY)
+	{
+		const Snake * s = snake_state(0);
+		head = s->head;
+		dir = s->dir;
+		next = s->turnCount ? s->turn[s->turnPos] : s->dir;
+		if (TheGame.state == GS_PLAYING)
+			ahead = TheGame.move[0] < 0x100 ? (byte)TheGame.move[0] >> 5 : 7;
+	}
+
+	sword px = (head & (ARENA_W - 1)) * 8 + dir.x * ahead;
+	sword py = (head >> ARENA_SHIFT) * 8 + dir.y * ahead;
+	byte  cx = arena_follow(cam_x, px, WINDOW_W, CAM_MARGIN_X, CAM_X_MAX);
+	byte  cy = arena_follow(cam_y, py, WINDOW_H, CAM_MARGIN_Y, CAM_Y_MAX);
+	byte ox = cx >> 3, oy = cy >> 3;
+	bool flipped = false;
+
+	if (ox != view_x || oy != view_y)
+	{
+		if (build_x == ox && build_y == oy && build_rows == VIEW_ROWS)
+		{
+			arena_flip();
+			flipped = true;
+		}
+		else
+		{
+			// Not there yet, wait at the edge of the visible page
+			if (build_x != ox || build_y != oy)
+				arena_build_start(ox, oy);
+
+			byte x0 = view_x * 8, y0 = view_y * 8;
+			cx = cx < x0 ? x0 : cx > x0 + 7 ? x0 + 7 : cx;
+			cy = cy < y0 ? y0 : cy > y0 + 7 ? y0 + 7 : cy;
+		}
+	}
+	else
+	{
+		// Get the page ready that the window is going to need first,
+		// a queued turn tells where the head goes next
+		sbyte sx, sy;
+		byte  dx = arena_due(cx, px, next.x, WINDOW_W, CAM_MARGIN_X, &sx);
+		byte  dy = arena_due(cy, py, next.y, WINDOW_H, CAM_MARGIN_Y, &sy);
+		byte  nx = view_x + sx, ny = view_y + sy;
+
+		if (nx > (CAM_X_MAX >> 3))
+			dx = 0xFF;
+		if (ny > (CAM_Y_MAX >> 3))
+			dy = 0xFF;
+
+		if (dx <= dy)
+			ny = view_y;
+		else
+			nx = view_x;
+
+		if ((dx != 0xFF || dy != 0xFF) && (nx != build_x || ny != build_y))
+			arena_build_start(nx, ny);
+	}
+
+	cam_x = cx;
+	cam_y = cy;
+
+	// Row 1 starts 0..7 lines above the window line, the fine scroll
+	// that puts it right on the split line moves the split a line down
+	byte fy = (3 - (cy & 7)) & 7;
+	hal_scroll_set(fy == (ARENA_SPLIT_LINE & 7) ? ARENA_SPLIT_LINE + 1 : ARENA_SPLIT_LINE,
+		VIEW_CTRL1 | fy, VIEW_CTRL2 | (7 - (cx & 7)));
+
+	// The flip took this frame's time already
+	if (!flipped && build_x != 0xFF)
+		arena_build(ARENA_BUILD_ROWS);
+}
+#endif
+
+// The static part of the title screen. The game shows a run length
+// image of it made by tools/mktitle.c, run title.bat after changing it.
+#ifdef SNAKE_TITLE_TOOL
+// Draw big 5x5 block text using PETSCII_BLOCK. Characters are drawn
+// 6 columns apart so up to 6 characters fit across 40 columns.
+static void draw_big_text(byte x0, byte y0, const char *text, char color)
+{
+    for (byte i = 0; text[i]; i++)
+    {
+        const byte * glyph = font_glyph(text[i]);
+        if (glyph)
+        {
+            for (byte row = 0; row < 5; row++)
+            {
+                byte   bits = glyph[row];
+                byte * sp = ScreenRow[y0 + row] + x0;
+                byte * cp = ColorRow[y0 + row] + x0;
+
+                for (byte col = 0; col < 5; col++)
+                {
+                    // Walk the bits from the left, MSB of the 5 is column 0
+                    if (bits & 0x10)
+                    {
+                        sp[col] = PETSCII_BLOCK;
+                        cp[col] = color;
+                    }
+                    // else leave existing background
+                    bits <<= 1;
+                }
+            }
+        }
+
+        /* Add one-column gap between characters by using 6-wide
+           spacing (5 pixels + 1 blank). */
+        x0 += 6;
+    }
+}
+
+void title_draw(void)
+{
+    // Simple selection screen
+    screen_init();
+
+    // Large title using 5x5 block font 
+    draw_big_text(5, 3, "SNAKE", VCOL_YELLOW);
+    draw_big_text(5, 9, "64", VCOL_YELLOW);
+
+    // Copyright notice
+    screen_print_petscii(18, 9,  "CHRIS CHANDLER", VCOL_CYAN);
+    screen_print_petscii(21, 11, "COPYRIGHT", VCOL_WHITE);
+    screen_print_petscii(21, 13, "(C)  2026", VCOL_WHITE);
+
+    // Control hints
+    screen_print_petscii(16,  16, "CONTROLS", VCOL_LT_RED);
+    screen_print_petscii(11,  18, "JOYSTICK ON PORT 2", VCOL_WHITE);
+    screen_print_petscii(13,  19, "KEYBOARD  WASD", VCOL_WHITE);
+    screen_print_petscii(3,   20, "2 PLAYERS - PORT 1 FIRE OR RETURN", VCOL_WHITE);
+    screen_print_petscii(4,   21, "PAUSE - FIRE BUTTON OR SPACE BAR", VCOL_WHITE);
+    screen_print_petscii(4,   22, "R REPLAY, F IN WARP, T GAME LOG", VCOL_WHITE);
+
+    // Speed curve, keys 1..3 pick one
+    screen_print_petscii(9,   23, "SPEED 1-3", VCOL_LT_RED);
+}
+#else
+#include "snake_title.h"
+
+void title_draw(void)
+{
+    // One pass over each image
+    screen_begin();
+    screen_unpack(Screen, TitleScreenRle);
+    screen_unpack(Color, TitleColorRle);
+}
+#endif
+
+// --------------------------
+// Input log
+// Every game is recorded from its first moving frame as runs of frames
+// with the same input: the sticks as snake_control() gets them and the
+// pause button. With the seed, the speed curve and the players saved
+// alongside, playing the log back repeats the game exactly. R on the
+// title replays the last game, F replays it in warp: no frame waits,
+// nothing drawn, as fast as the game logic runs. A replay that ends
+// compares the outcome with the recording.
+// --------------------------
+
+#define ReplayLog       HAL_PTR(0xb000)
+#define REPLAY_RUNS     0x800       // two bytes each, $B000-$BFFF
+#define REPLAY_RUN_MAX  0x7F        // frames per run, bit 7 is the button
+
+typedef enum
+{
+	REPLAY_OFF,
+	REPLAY_RECORD,
+	REPLAY_PLAY
+} ReplayMode;
+
+typedef enum
+{
+	REPLAY_NONE,        // nothing played back since the last look
+	REPLAY_MATCH,       // ended just like the recording
+	REPLAY_DIFFER       // took another course
+} ReplayVerdict;
+
+typedef struct
+{
+	word    seed;           // rng seed of the game
+	byte    players;
+	byte    curve;          // speed curve
+	byte    scale;          // speed scale of the machine it ran on
+	byte    attract;        // computer demo game
+	bool    complete;       // recorded to the end, not cut off by a full log
+	word    runs;           // runs in the log
+	word    frames;         // moving and paused frames of the game
+	word    outcome;        // hash of where the game ended
+} ReplayInfo;
+
+static ReplayInfo replay;               // the last game recorded
+static byte replay_mode    = REPLAY_OFF;
+static bool replay_warp    = false;     // playback without waits or drawing
+static byte replay_verdict = REPLAY_NONE;
+
+static word replay_pos;                 // next run to play
+static byte replay_left;                // frames left in the run playing
+static word replay_frames;              // frames recorded or played so far
+
+// This frame's input as the game sees it
+static sbyte game_jx[SNAKE_PLAYERS], game_jy[SNAKE_PLAYERS];
+static byte  game_btn;
+
+// Start of a game, from game_state(GS_PLAYING) before the first heart
+void replay_begin(void)
+{
+	replay_frames = 0;
+
+	if (replay_mode == REPLAY_PLAY)
+	{
+		replay_pos = 0;
+		replay_left = 0;
+		rng_seed(replay.seed);
+	}
+	else
+	{
+		replay_mode = REPLAY_RECORD;
+		replay_verdict = REPLAY_NONE;
+		replay.seed = rng_seed_used;
+		replay.players = snake_players;
+		replay.curve = speed_curve;
+		replay.scale = speed_scale;
+		replay.attract = TheGame.attract;
+		replay.complete = false;
+		replay.runs = 0;
+	}
+}
+
+// Play the last game back from the title
+void replay_start(bool warp)
+{
+	snake_players = replay.players;
+	speed_curve_select(replay.curve);
+	speed_scale = replay.scale;
+	TheGame.attract = replay.attract;
+
+	replay_mode = REPLAY_PLAY;
+	replay_warp = warp;
+	replay_verdict = REPLAY_NONE;
+}
+
+// Where the game ended up, the replay has to end up there too
+static word replay_outcome(void)
+{
+	word h = fruit_pos ^ replay_frames;
+
+	for (byte p = 0; p < snake_players; p++)
+	{
+		const Snake * s = snake_state(p);
+		h = h * 31 + s->head;
+		h = h * 31 + s->length;
+		for (byte i = 0; i < SCORE_BYTES; i++)
+			h = h * 31 + TheGame.score[p][i];
+	}
+
+	return h;
+}
+
+// End of a game, back to the title
+void replay_end(void)
+{
+	if (replay_mode == REPLAY_RECORD)
+	{
+		replay.complete = true;
+		replay.frames = replay_frames;
+		replay.outcome = replay_outcome();
+	}
+	else if (replay_mode == REPLAY_PLAY && replay.complete)
+	{
+		replay_verdict = replay_frames == replay.frames && replay_outcome() == replay.outcome ?
+			REPLAY_MATCH : REPLAY_DIFFER;
+	}
+
+	replay_mode = REPLAY_OFF;
+	replay_warp = false;
+	speed_scale = speed_scale_native;
+}
+
+// Add the frame to the log, a full log ends the recording there
+static void replay_write(void)
+{
+	byte sticks = 0;
+	for (byte p = 0; p < snake_players; p++)
+		sticks |= ((game_jx[p] & 3) | (game_jy[p] & 3) << 2) << (4 * p);
+
+	byte * rp = ReplayLog + 2 * replay.runs;
+	byte   head = game_btn << 7 | 1;
+
+	if (replay.runs && rp[-1] == sticks && (rp[-2] & 0x80) == (head & 0x80) && (rp[-2] & REPLAY_RUN_MAX) < REPLAY_RUN_MAX)
+		rp[-2]++;
+	else if (replay.runs < REPLAY_RUNS)
+	{
+		rp[0] = head;
+		rp[1] = sticks;
+		replay.runs++;
+	}
+	else
+	{
+		replay_mode = REPLAY_OFF;
+		return;
+	}
+
+	replay_frames++;
+}
+
+// Next frame from the log, false at its end
+static bool replay_read(void)
+{
+	if (!replay_left)
+	{
+		if (replay_pos == replay.runs)
+			return false;
+
+		const byte * rp = ReplayLog + 2 * replay_pos++;
+		replay_left = rp[0] & REPLAY_RUN_MAX;
+		game_btn = rp[0] >> 7;
+
+		byte sticks = rp[1];
+		for (byte p = 0; p < SNAKE_PLAYERS; p++)
+		{
+			sbyte x = sticks & 3, y = (sticks >> 2) & 3;
+			game_jx[p] = x == 3 ? -1 : x;
+			game_jy[p] = y == 3 ? -1 : y;
+			sticks >>= 4;
+		}
+	}
+
+	replay_left--;
+	replay_frames++;
+	return true;
+}
+
+// The frame's input for the game: played back, or taken from the
+// sampled controls and the computer players and recorded. False when a
+// replay ran out.
+bool game_input(bool sticks)
+{
+	if (replay_mode == REPLAY_PLAY)
+		return replay_read();
+
+	game_btn = input_btn[0] | input_btn[1];
+
+#ifndef SNAKE_ARENA
+	// Computer players search a little further every frame
+	bool ai = false;
+	for (byte p = 0; p < snake_players; p++)
+		ai |= g_controlMode[p] == CTRL_AI;
+	if (sticks && ai)
+		ai_update();
+#endif
+
+	for (byte p = 0; p < snake_players; p++)
+	{
+		sbyte jx = 0, jy = 0;
+		if (sticks)
+		{
+			jx = input_jx[p];
+			jy = input_jy[p];
+#ifndef SNAKE_ARENA
+			if (g_controlMode[p] == CTRL_AI)
+			{
+				snake_select(p);
+				ai_steer(&jx, &jy);
+			}
+#endif
+		}
+		game_jx[p] = jx;
+		game_jy[p] = jy;
+	}
+
+	if (replay_mode == REPLAY_RECORD)
+		replay_write();
+
+	return true;
+}
+
+// Start the next frame. A warp replay doesn't wait and drops what the
+// last frame queued for the screen.
+void frame_next(void)
+{
+	if (replay_warp)
+	{
+		dq_count = 0;
+		frame_resync();
+	}
+	else
+		frame_wait();
+}
+
+// --------------------------
+// High score table
+// The ten best scores live in SNAKE.HI on the drive the game came from,
+// a small SEQ file of two marker bytes, the scores as packed BCD best
+// first and a check byte. The title loads it, a game over adds the
+// scores and saves it again. Disk work is one step per frame: a few
+// bytes through the KERNAL, or frames of waiting while the drive
+// searches and writes on its own, so the title and the game over flash
+// keep running. A missing drive answers at once and the table stays in
+// memory only.
+// --------------------------
+
+#define HS_ENTRIES      10
+#define HS_BYTES        (HS_ENTRIES * SCORE_BYTES)
+#define HS_FILE_SIZE    (2 + HS_BYTES + 1)
+#define HS_FILE_NAME    "SNAKE.HI"
+#define HS_FNUM         2           // logical file of SNAKE.HI
+#define HS_CMD          15          // logical file of the command channel
+#define HS_CHUNK        4           // bytes moved per frame
+#define HS_OPEN_FRAMES      25      // drive looking for the file
+#define HS_SCRATCH_FRAMES   50      // drive deleting the old file
+#define HS_CLOSE_FRAMES     50      // drive writing the last block
+#define HS_SHOW_FRAMES  250         // title frames of scores, then controls
+#define HS_ROW          16          // title rows the scores take turns on
+#define HS_ROWS         7
+
+typedef enum
+{
+	HS_IDLE,
+	HS_LOAD,        // reading the file
+	HS_SCRATCH,     // drive deleting the old file
+	HS_SAVE,        // writing the new one
+	HS_CLOSE        // written, the command channel is still open
+} HsStep;
+
+static byte hs_table[HS_BYTES];         // best first, packed BCD
+static byte hs_file[HS_FILE_SIZE];      // file image on its way to or from disk
+static byte hs_step   = HS_IDLE;
+static byte hs_wait   = 0;              // frames before the next step
+static byte hs_pos;                     // file bytes moved
+static byte hs_device = 0xFF;           // drive, 0 when none answered, 0xFF not asked yet
+static bool hs_loaded = false;          // table holds what was on disk
+static bool hs_dirty  = false;          // table has scores the disk lacks
+
+// Put a score in its place, below equal ones, true if it made the table
+bool hs_insert(byte * table, const byte * score)
+{
+	byte * e = table + HS_BYTES - SCORE_BYTES;
+	if (!bcd_greater(score, e))
+		return false;
+
+	while (e != table && bcd_greater(score, e - SCORE_BYTES))
+	{
+		bcd_copy(e, e - SCORE_BYTES);
+		e -= SCORE_BYTES;
+	}
+	bcd_copy(e, score);
+	return true;
+}
+
+static byte hs_check(void)
+{
+	byte c = 0x5A;
+	for (byte i = 0; i < HS_BYTES; i++)
+		c ^= hs_file[2 + i];
+	return c;
+}
+
+// A loaded image is only used when it can be a table this game wrote
+static bool hs_valid(void)
+{
+	if (hs_pos != HS_FILE_SIZE || hs_file[0] != 'S' || hs_file[1] != 'H' || hs_file[HS_FILE_SIZE - 1] != hs_check())
+		return false;
+
+	const byte * e = hs_file + 2;
+	for (byte i = 0; i < HS_BYTES; i++)
+	{
+		if ((e[i] & 0x0F) > 9 || e[i] > 0x99)
+			return false;
+	}
+	for (byte i = 1; i < HS_ENTRIES; i++)
+	{
+		if (bcd_greater(e + i * SCORE_BYTES, e + (i - 1) * SCORE_BYTES))
+			return false;
+	}
+	return true;
+}
+
+// The file is in, scores of games played before it was are added to it
+static void hs_merge(bool valid)
+{
+	if (valid)
+	{
+		byte * disk = hs_file + 2;
+		bool   more = false;
+
+		for (byte i = 0; i < HS_ENTRIES; i++)
+			more |= hs_insert(disk, hs_table + i * SCORE_BYTES);
+		memcpy(hs_table, disk, HS_BYTES);
+		hs_dirty = more;
+	}
+	hs_loaded = true;
+
+	if (bcd_greater(hs_table, TheGame.highScore))
+		bcd_copy(TheGame.highScore, hs_table);
+}
+
+// Open a file or channel, a drive that doesn't answer is given up on
+static bool hs_open(byte fnum, byte channel, const char * name)
+{
+	if (hal_disk_open(fnum, hs_device, channel, name))
+		return true;
+
+	hs_device = 0;
+	hs_step = HS_IDLE;
+	return false;
+}
+
+// One step of disk work, on the title and during the game over flash
+void hs_update(void)
+{
+	if (hs_device == 0xFF)
+		hs_device = hal_disk_device();
+	if (!hs_device)
+		return;
+
+	if (hs_wait)
+	{
+		hs_wait--;
+		return;
+	}
+
+	switch (hs_step)
+	{
+	case HS_IDLE:
+		if (!hs_loaded)
+		{
+			if (hs_open(HS_FNUM, 2, HS_FILE_NAME ",S,R"))
+			{
+				hs_step = HS_LOAD;
+				hs_pos = 0;
+				hs_wait = HS_OPEN_FRAMES;
+			}
+		}
+		else if (hs_dirty)
+		{
+			// Scratch first, the drive won't write over a file
+			if (hs_open(HS_CMD, 15, "S0:" HS_FILE_NAME))
+			{
+				hs_step = HS_SCRATCH;
+				hs_wait = HS_SCRATCH_FRAMES;
+			}
+		}
+		break;
+
+	case HS_LOAD:
+	{
+		byte n = HS_FILE_SIZE - hs_pos;
+		if (n > HS_CHUNK)
+			n = HS_CHUNK;
+
+		byte got = hal_disk_read(HS_FNUM, hs_file + hs_pos, n);
+		hs_pos += got;
+		if (got < n || hs_pos == HS_FILE_SIZE)
+		{
+			hal_disk_close(HS_FNUM);
+			hs_merge(hs_valid());
+			hs_step = HS_IDLE;
+		}
+		break;
+	}
+
+	case HS_SCRATCH:
+		hs_file[0] = 'S';
+		hs_file[1] = 'H';
+		memcpy(hs_file + 2, hs_table, HS_BYTES);
+		hs_file[HS_FILE_SIZE - 1] = hs_check();
+
+		if (hs_open(HS_FNUM, 2, HS_FILE_NAME ",S,W"))
+		{
+			hs_step = HS_SAVE;
+			hs_pos = 0;
+			hs_wait = HS_OPEN_FRAMES;
+		}
+		else
+			hal_disk_close(HS_CMD);
+		break;
+
+	case HS_SAVE:
+	{
+		byte n = HS_FILE_SIZE - hs_pos;
+		if (n > HS_CHUNK)
+			n = HS_CHUNK;
+
+		if (!hal_disk_write(HS_FNUM, hs_file + hs_pos, n))
+		{
+			// Disk full or write protected, keep the scores in memory
+			hal_disk_close(HS_FNUM);
+			hal_disk_close(HS_CMD);
+			hs_dirty = false;
+			hs_step = HS_IDLE;
+		}
+		else if ((hs_pos += n) == HS_FILE_SIZE)
+		{
+			hal_disk_close(HS_FNUM);
+			hs_dirty = false;
+			hs_step = HS_CLOSE;
+			hs_wait = HS_CLOSE_FRAMES;
+		}
 		break;
+	}
 
-	case GS_PAUSED:
-		// Optional: draw something else while paused
+	case HS_CLOSE:
+		hal_disk_close(HS_CMD);
+		hs_step = HS_IDLE;
 		break;
 	}
 }
 
-// Colors for collision "animation"
-char FlashColors[] = {
-	VCOL_YELLOW,
-	VCOL_WHITE,
-	VCOL_LT_GREY,
-	VCOL_YELLOW,
-	VCOL_ORANGE,
-	VCOL_RED,
-	VCOL_MED_GREY,
-	VCOL_DARK_GREY
-};
-
-void pause_backup_region(void)
+// A game starts, files still open are closed. A cut off load or save
+// is tried again from the start at the next game over or title.
+void hs_abort(void)
 {
-	for (byte y = 0; y < PAUSE_H; y++)
+	if (hs_step != HS_IDLE)
 	{
-		for (byte x = 0; x < PAUSE_W; x++)
-		{
-			byte sx = PAUSE_X + x;
-			byte sy = PAUSE_Y + y;
-			pause_backup_chars[y][x]  = screen_get(sx, sy);
-			pause_backup_colors[y][x] = Color[40 * sy + sx];
-		}
+		hal_disk_close(HS_FNUM);
+		if (hs_step != HS_LOAD)
+			hal_disk_close(HS_CMD);
+		hs_step = HS_IDLE;
+		hs_wait = 0;
 	}
 }
 
-void pause_restore_region(void)
+// Game over, the players' scores go in the table. Demo games and
+// replays don't count.
+void hs_game_over(void)
 {
-	for (byte y = 0; y < PAUSE_H; y++)
-	{
-		for (byte x = 0; x < PAUSE_W; x++)
-		{
-			byte sx = PAUSE_X + x;
-			byte sy = PAUSE_Y + y;
-			screen_put(sx, sy,
-			           pause_backup_chars[y][x],
-			           pause_backup_colors[y][x]);
-		}
-	}
+	if (TheGame.attract || replay_mode == REPLAY_PLAY)
+		return;
+
+	for (byte p = 0; p < snake_players; p++)
+		hs_dirty |= hs_insert(hs_table, TheGame.score[p]);
 }
 
-void pause_draw_banner(void)
+bool hs_any(void)
 {
-	const char *text = "GAME PAUSED";
+	byte any = 0;
+	for (byte i = 0; i < SCORE_BYTES; i++)
+		any |= hs_table[i];
+	return any != 0;
+}
 
-	for (byte y = 0; y < PAUSE_H; y++)
+// Title rows with the table or the controls again, the hidden page and
+// the color shadow still hold the controls from the title image
+void hs_title(bool table)
+{
+	if (table)
 	{
-		for (byte x = 0; x < PAUSE_W; x++)
-		{
-			byte sx = PAUSE_X + x;
-			byte sy = PAUSE_Y + y;
+		for (byte y = HS_ROW; y < HS_ROW + HS_ROWS; y++)
+			memset(ScreenRow[y], ' ', 40);
 
-			if (y == 1)
-			{
-				// Middle row: text
-				char c = text[x];
-				byte sc = petscii_to_screen(c);
-				screen_put(sx, sy, sc, VCOL_YELLOW);
-			}
-			else
+		screen_print_petscii(14, HS_ROW, "HIGH SCORES", VCOL_LT_RED);
+
+		const byte * e = hs_table;
+		for (byte i = 0; i < HS_ENTRIES; i++)
+		{
+			// "10. 001234"
+			char line[11];
+			byte rank = i + 1;
+			line[0] = rank >= 10 ? '1' : ' ';
+			line[1] = '0' + rank % 10;
+			line[2] = '.';
+			line[3] = ' ';
+			for (byte b = 0; b < SCORE_BYTES; b++)
 			{
-				// Top/bottom row: solid block for "large" look
-				screen_put(sx, sy, PETSCII_BLOCK, VCOL_DARK_GREY);
+				byte d = e[SCORE_BYTES - 1 - b];
+				line[4 + 2 * b] = '0' + (d >> 4);
+				line[5 + 2 * b] = '0' + (d & 0x0F);
 			}
+			line[10] = 0;
+			e += SCORE_BYTES;
+
+			screen_print_petscii(i < 5 ? 8 : 22, HS_ROW + 2 + i % 5, line, i ? VCOL_WHITE : VCOL_YELLOW);
 		}
 	}
+	else
+	{
+		memcpy(ScreenRow[HS_ROW], ScreenPages[screen_front ^ 1] + HS_ROW * 40, HS_ROWS * 40);
+		memcpy(ColorRow[HS_ROW], ColorShadow + HS_ROW * 40, HS_ROWS * 40);
+	}
 }
 
-void pause_enter(void)
+// --------------------------
+// Play statistics
+// Counted from the game events over the whole session, demo games and
+// replays leave them alone.
+// --------------------------
+
+typedef struct
 {
-	pause_backup_region();
-	TheGame.pauseFlashCounter = 0;
-	TheGame.pauseVisible      = 0;
-}
+	word    games;
+	word    hearts;
+	word    levels;         // levels done
+	word    records;        // hearts that raised the high score
+} GameStats;
 
-void pause_update(void)
+static GameStats stats;
+
+void stats_event(byte type)
 {
-	// Flash every X frames
-	if (++TheGame.pauseFlashCounter >= PAUSE_FLASH_FRAMES)
-	{
-		TheGame.pauseFlashCounter = 0;
+	if (TheGame.attract || replay_mode == REPLAY_PLAY)
+		return;
 
-		if (TheGame.pauseVisible)
-		{
-			pause_restore_region();
-			TheGame.pauseVisible = 0;
-		}
-		else
-		{
-			pause_draw_banner();
-			TheGame.pauseVisible = 1;
-		}
+	switch (type)
+	{
+	case EV_HEART:
+		stats.hearts++;
+		break;
+	case EV_HIGHSCORE:
+		stats.records++;
+		break;
+	case EV_LEVEL:
+		stats.levels++;
+		break;
+	case EV_DEATH:
+		stats.games++;
+		break;
 	}
 }
 
-void pause_exit(void)
+// Sound consumer, the effects in the order the game logic posted them
+void sound_event(byte type)
 {
-	if (TheGame.pauseVisible)
+	switch (type)
 	{
-		pause_restore_region();
-		TheGame.pauseVisible = 0;
+	case EV_STEP:
+		sound_step();
+		break;
+	case EV_HEART:
+		sound_heart();
+		break;
+	case EV_HIGHSCORE:
+		sound_highscore();
+		break;
+	case EV_DEATH:
+		sound_death();
+		break;
 	}
 }
 
 // --------------------------
-// Simple SID sound engine
-// Voice 1 - death SFX
-// Voice 2 - step and heart SFX
-// Voice 3 - high score SFX
+// Telemetry
+// The records of the last TLM_GAMES games in a ring at $AC00, behind a
+// header and the session statistics. The header starts with SNAKETLM in
+// ASCII, so tools find the block in a memory dump and the web player in
+// the emulator's memory. T on the title shows it, S there writes it to
+// disk as SNAKE.TLM. A game is logged when it ends in a crash, replays
+// are not logged again.
 // --------------------------
 
-static byte step_toggle  = 0;
-
-// Voice 1 death sound state
-static byte      death_frames = 0; // frames remaining for death sound
-static unsigned  death_freq   = 0; // current frequency for slide
-static byte      v1_ctrl      = 0; // shadow copy of SID_V1_CTRL
+#define TLM_GAMES       16          // records in the ring, a power of two
+#define TLM_VERSION     1
+#define TLM_ATTRACT     0x80        // flags bit of a demo game
+#define TLM_FILE_NAME   "SNAKE.TLM"
 
-// Voice 2 state
-static byte      sfx2_frames  = 0;      // lifetime of current sound on voice 2
-static byte      v2_ctrl      = 0;      // shadow copy of SID_V2_CTRL
-
-// Voice 3 high score state
-static byte      hs_active    = 0;      // 1 while coin sound is playing
-static byte      hs_timer     = 0;      // frames until next arpeggio step
-static byte      hs_index     = 0;      // which step of the arpeggio we are on
-static byte      v3_ctrl      = 0;      // shadow copy of SID_V3_CTRL
-
-// Simple upward arpeggio for coin style sound
-static const unsigned hs_freqs[] = {
-    0x1800,
-    0x1C00,
-    0x2000,
-    0x2400
-};
+typedef struct
+{
+	char            magic[8];       // SNAKETLM
+	byte            version;
+	byte            size;           // bytes per record
+	byte            slots;          // records in the ring
+	byte            head;           // slot of the next record
+	word            games;          // records written
+	word            reserved;
+	GameStats       stats;          // session statistics at the last record
+	byte            pad[8];
+	TelemetryGame   ring[TLM_GAMES];
+} TelemetryBlock;
+
+#define Telemetry   ((TelemetryBlock *)HAL_PTR(0xac00))
+
+static const char TlmMagic[8] = { 0x53, 0x4E, 0x41, 0x4B, 0x45, 0x54, 0x4C, 0x4D };
+
+static word tlm_overruns;           // frame_overruns when the game started
+
+// Empty ring, once at startup
+void tlm_init(void)
+{
+	TelemetryBlock * t = Telemetry;
 
-#define HS_STEPS (sizeof(hs_freqs) / sizeof(hs_freqs[0]))
-#define HS_STEP_FRAMES 3          // frames per note in the arpeggio
+	memset(t, 0, sizeof(TelemetryBlock));
+	memcpy(t->magic, TlmMagic, sizeof(TlmMagic));
+	t->version = TLM_VERSION;
+	t->size = sizeof(TelemetryGame);
+	t->slots = TLM_GAMES;
+}
 
-void sound_init(void)
+// A new game, its record starts empty
+void tlm_begin(void)
 {
-    // Master volume 15, no filter
-    SID_MODE_VOL = 0x0F;
-
-    // Voice 1: death SFX
-    SID_V1_AD = 0x28;          // fast attack, short decay
-    SID_V1_SR = 0x88;          // moderate sustain, release
+	memset(&tlm_game, 0, sizeof(tlm_game));
+	tlm_game.flags = snake_players | (TheGame.attract ? TLM_ATTRACT : 0);
+	tlm_overruns = frame_overruns;
+}
 
-    // Pulse width is not important for SAW, but set something valid
-    SID_V1_PW_LO = 0x00;
-    SID_V1_PW_HI = 0x08;
+// Telemetry consumer of the game events, a death closes the record
+void tlm_event(byte type)
+{
+	// The heart placed for the old board goes with it, the level places
+	// its own
+	if (type == EV_LEVEL && fruit_pos != FRUIT_NONE)
+	{
+		tlm_game.spawns--;
+		tlm_game.tries -= tlm_fruit_tries;
+	}
 
-    // Sawtooth waveform, gate off to start
-    v1_ctrl = SID_CTRL_SAW;
-    SID_V1_CTRL = v1_ctrl;
+	if (type != EV_DEATH || replay_mode == REPLAY_PLAY)
+		return;
 
-    death_frames = 0;
-    death_freq   = 0;
+	TelemetryBlock * t = Telemetry;
 
-    // Voice 2 - general SFX voice
-    SID_V2_AD = 0x48;          // attack 4, decay 8
-    SID_V2_SR = 0x88;          // sustain 8, release 8
+	tlm_game.overruns = frame_overruns - tlm_overruns;
+	tlm_game.level = TheGame.level;
+	t->ring[t->head] = tlm_game;
+	t->head = (t->head + 1) & (TLM_GAMES - 1);
+	t->games++;
+	t->stats = stats;
+}
 
-    // Triangle waveform, gate off
-    v2_ctrl = SID_CTRL_TRI;    // triangle only, no gate
-    SID_V2_CTRL = v2_ctrl;
+// The block to SNAKE.TLM, false without a drive or on a disk error. The
+// debug screen waits for it, the high score work is stopped first.
+bool tlm_save(void)
+{
+	byte dev = hal_disk_device();
 
-    // Voice 3 - high score coin
-    SID_V3_AD = 0x28;          // fast attack, short decay
-    SID_V3_SR = 0x88;          // moderate sustain, release
+	if (!hal_disk_open(HS_CMD, dev, 15, "S0:" TLM_FILE_NAME))
+		return false;
 
-    SID_V3_PW_LO = 0x00;       // pulse width around 1/4
-    SID_V3_PW_HI = 0x08;
+	bool ok = hal_disk_open(HS_FNUM, dev, 2, TLM_FILE_NAME ",S,W");
+	const byte * p = (const byte *)Telemetry;
+	word left = sizeof(TelemetryBlock);
 
-    v3_ctrl = SID_CTRL_RECT;   // pulse waveform, gate off
-    SID_V3_CTRL = v3_ctrl;
+	while (ok && left)
+	{
+		byte n = left > 128 ? 128 : left;
+		ok = hal_disk_write(HS_FNUM, p, n);
+		p += n;
+		left -= n;
+	}
 
-    hs_active = 0;
-    hs_timer  = 0;
-    hs_index  = 0;
+	hal_disk_close(HS_FNUM);
+	hal_disk_close(HS_CMD);
+	return ok;
 }
 
-void sound_step(void)
+// Debug screen of the ring, newest game first and all numbers in hex.
+// Fire or space goes back, once let go again.
+void tlm_screen(void)
 {
-    // Two mid range frequencies
-    unsigned freq;
-
-    if (!step_toggle)
-        freq = 0x0900;          // medium pitch
-    else
-        freq = 0x0B00;          // slightly higher
+	const TelemetryBlock * t = Telemetry;
 
-    step_toggle ^= 1;
-
-    SID_V2_FREQ_LO = (byte)(freq & 0xFF);
-    SID_V2_FREQ_HI = (byte)(freq >> 8);
+	screen_begin();
+	memset(Screen, ' ', 1000);
+	memset(Color, VCOL_LT_GREY, 1000);
+
+	//          1         2         3
+	// 0123456789012345678901234567890123456789
+	// TICK FRAM PAUS PEAK SPWN TRYS OVER L P
+	screen_print_petscii(0, 0, "TELEMETRY           GAMES", VCOL_YELLOW);
+	screen_print_hex(ScreenRow[0] + 26, t->games);
+	screen_print_petscii(0, 2, "TICK FRAM PAUS PEAK SPWN TRYS OVER L P", VCOL_LT_RED);
+
+	byte slot = t->head;
+	byte n = t->games < TLM_GAMES ? t->games : TLM_GAMES;
+	for (byte i = 0; i < n; i++)
+	{
+		slot = (slot - 1) & (TLM_GAMES - 1);
+
+		const TelemetryGame * g = t->ring + slot;
+		byte * sp = ScreenRow[3 + i];
+		screen_print_hex(sp +  0, g->ticks);
+		screen_print_hex(sp +  5, g->frames);
+		screen_print_hex(sp + 10, g->paused);
+		screen_print_hex(sp + 15, g->peak);
+		screen_print_hex(sp + 20, g->spawns);
+		screen_print_hex(sp + 25, g->tries);
+		screen_print_hex(sp + 30, g->overruns);
+		sp[35] = g->level > 9 ? '+' : 0x30 + g->level;
+		sp[37] = g->flags & TLM_ATTRACT ? petscii_to_screen('D') : 0x30 + (g->flags & 3);
+	}
 
-    // Triangle waveform, gate ON
-    v2_ctrl = SID_CTRL_TRI | SID_CTRL_GATE;
-    SID_V2_CTRL = v2_ctrl;
+	screen_print_petscii(0, 20, "SESSION  GAMES      HEARTS", VCOL_LT_RED);
+	screen_print_hex(ScreenRow[20] + 15, stats.games);
+	screen_print_hex(ScreenRow[20] + 27, stats.hearts);
+	screen_print_petscii(9, 21, "LEVELS     RECORDS", VCOL_LT_RED);
+	screen_print_hex(ScreenRow[21] + 16, stats.levels);
+	screen_print_hex(ScreenRow[21] + 28, stats.records);
+	screen_print_petscii(0, 23, "S SAVES TO DISK, FIRE OR SPACE RETURNS", VCOL_WHITE);
 
-    // Short beep
-    sfx2_frames = 6;
-}
+	screen_show();
 
-void sound_heart(void)
-{
-    // Higher, bright pickup sound
-    unsigned freq = 0x1400;    // significantly higher pitch
+	while (!is_fire_pressed() && !is_space_pressed())
+	{
+		frame_wait();
 
-    SID_V2_FREQ_LO = (byte)(freq & 0xFF);
-    SID_V2_FREQ_HI = (byte)(freq >> 8);
+		if (is_key_pressed(0xFD, 0x20))
+		{
+			memset(ScreenRow[24], ' ', 40);
+			screen_print_petscii(0, 24, tlm_save() ? "SAVED AS " TLM_FILE_NAME : "NO DRIVE OR DISK ERROR", VCOL_YELLOW);
+			frame_resync();
 
-    // Same triangle waveform, gate ON
-    v2_ctrl = SID_CTRL_TRI | SID_CTRL_GATE;
-    SID_V2_CTRL = v2_ctrl;
+			while (is_key_pressed(0xFD, 0x20))
+				frame_wait();
+		}
+	}
 
-    // Longer beep for heart
-    sfx2_frames = 14;
+	while (is_fire_pressed() || is_space_pressed())
+		frame_wait();
 }
 
-void sound_highscore(void)
+// Hand the frame's events to their consumers, once per frame after the
+// game loop. A warp replay draws no HUD.
+void game_events(void)
 {
-    // Start or restart the coin arpeggio on voice 3
-    hs_active = 1;
-    hs_index  = 0;
-
-    // Kick off first note immediately
-    {
-        unsigned freq = hs_freqs[0];
-        SID_V3_FREQ_LO = (byte)(freq & 0xFF);
-        SID_V3_FREQ_HI = (byte)(freq >> 8);
-    }
-
-    // Gate on pulse waveform
-    v3_ctrl = SID_CTRL_RECT | SID_CTRL_GATE;
-    SID_V3_CTRL = v3_ctrl;
+	for (byte i = 0; i < ev_count; i++)
+	{
+		byte type = ev_type[i];
+		sound_event(type);
+		stats_event(type);
+		tlm_event(type);
+		if (!replay_warp)
+			hud_event(type, ev_arg[i]);
+	}
+	ev_count = 0;
 
-    hs_timer = HS_STEP_FRAMES;
+	if (!replay_warp)
+		hud_update();
 }
 
-void sound_death(void)
+// Frames on the title before the computer starts a demo game, 0 never.
+// The computer player only knows the screen playfield, the arena has no
+// demo.
+#ifdef SNAKE_ARENA
+#undef ATTRACT_FRAMES
+#define ATTRACT_FRAMES  0
+#elif !defined(ATTRACT_FRAMES)
+#define ATTRACT_FRAMES  750
+#endif
+
+// Title with the settings and how the last replay went
+void title_show(void)
 {
-    // Start a descending sawtooth tone on voice 1.
-    // Think "waaah" style game over slide.
+    title_draw();
+    screen_print_petscii(20,  23, SpeedCurveNames[speed_curve], VCOL_WHITE);
 
-    death_frames = 24;        // total lifetime in frames
-    death_freq   = 0x0C00;    // start fairly high
+    // How the last replay went
+    if (replay_verdict == REPLAY_MATCH)
+        screen_print_petscii(13, 15, "REPLAY MATCHES", VCOL_GREEN);
+    else if (replay_verdict == REPLAY_DIFFER)
+        screen_print_petscii(13, 15, "REPLAY DIFFERS", VCOL_RED);
 
-    // Set initial frequency
-    SID_V1_FREQ_LO = (byte)(death_freq & 0xFF);
-    SID_V1_FREQ_HI = (byte)(death_freq >> 8);
+    // Up in one go
+    screen_show();
 
-    // Gate on sawtooth
-    v1_ctrl = SID_CTRL_SAW | SID_CTRL_GATE;
-    SID_V1_CTRL = v1_ctrl;
+    // The controls stay on the hidden page while the high scores show
+    memcpy(ScreenPages[screen_front ^ 1] + HS_ROW * 40, ScreenRow[HS_ROW], HS_ROWS * 40);
 }
 
-void sound_update(void)
+void select_controls(void)
 {
-    // Voice 1 death sound slide
-    if (death_frames)
-    {
-        death_frames--;
+    // Title screen polls the hardware directly
+    frame_sampling = 0;
+    TheGame.attract = 0;
 
-        // Slide the pitch downward a bit each frame
-        if (death_freq > 0x0200)
-        {
-            death_freq -= 0x0018;   // tune this for a faster or slower slide
-        }
+    title_show();
+    byte hs_show = 0;
+    bool hs_shown = false;
 
-        SID_V1_FREQ_LO = (byte)(death_freq & 0xFF);
-        SID_V1_FREQ_HI = (byte)(death_freq >> 8);
+    // Wait for Joystick button or Spacebar
+    for (word idle = 0; ; idle++)
+    {
+        frame_wait();
 
-        if (!death_frames)
+        // Table from disk, or the last game's scores on their way there
+        hs_update();
+        if (++hs_show == HS_SHOW_FRAMES)
         {
-            // End of slide, gate off
-            v1_ctrl &= (byte)~SID_CTRL_GATE;
-            SID_V1_CTRL = v1_ctrl;
+            hs_show = 0;
+            hs_shown = !hs_shown && hs_any();
+            hs_title(hs_shown);
         }
-    }
 
-    // Voice 2 lifetime management
-    if (sfx2_frames)
-    {
-        sfx2_frames--;
-        if (!sfx2_frames)
+        // Port 1 fire before any key, it pulls the same line as space
+        if (is_fire1_pressed())
         {
-            // Turn off gate, keep waveform bits
-            v2_ctrl &= (byte)~SID_CTRL_GATE;
-            SID_V2_CTRL = v2_ctrl;
+            snake_players = 2;
+            g_controlMode[0] = CTRL_JOYSTICK;
+            g_controlMode[1] = CTRL_JOYSTICK1;
+            break;
         }
-    }
 
-    // Voice 3 high score coin arpeggio
-    if (hs_active)
-    {
-        if (hs_timer > 0)
-            hs_timer--;
+        // Keys 1, 2 and 3 select the speed curve
+        if (is_key_pressed(0x7F, 0x01))
+            speed_curve_select(SPEED_CURVE_LINEAR);
+        else if (is_key_pressed(0x7F, 0x08))
+            speed_curve_select(SPEED_CURVE_QUADRATIC);
+        else if (is_key_pressed(0xFD, 0x01))
+            speed_curve_select(SPEED_CURVE_CUSTOM);
 
-        if (!hs_timer)
+        screen_print_petscii(20, 23, SpeedCurveNames[speed_curve], VCOL_WHITE);
+
+        // T shows the telemetry of the last games
+        if (is_key_pressed(0xFB, 0x40))
         {
-            hs_index++;
+            hs_abort();
+            tlm_screen();
+            title_show();
+            hs_show = 0;
+            hs_shown = false;
+            idle = 0;
+        }
 
-            if (hs_index >= HS_STEPS)
-            {
-                // End of arpeggio - turn off gate
-                hs_active = 0;
-                v3_ctrl &= (byte)~SID_CTRL_GATE;
-                SID_V3_CTRL = v3_ctrl;
-            }
-            else
+        // R replays the last game, F the same in warp
+        if (replay.runs)
+        {
+            bool warp = is_key_pressed(0xFB, 0x20);
+            if (warp || is_key_pressed(0xFB, 0x02))
             {
-                unsigned freq = hs_freqs[hs_index];
-                SID_V3_FREQ_LO = (byte)(freq & 0xFF);
-                SID_V3_FREQ_HI = (byte)(freq >> 8);
-
-                hs_timer = HS_STEP_FRAMES;
+                replay_start(warp);
+                break;
             }
         }
-    }
-}
-
-// Stop any ongoing sounds and turn off SID gates
-void sound_stop_all(void)
-{
-    // Stop timers/state
-    death_frames = 0;
-    sfx2_frames  = 0;
-    hs_active    = 0;
-    hs_timer     = 0;
-    hs_index     = 0;
-
-    // Turn off gates on all voices
-    v1_ctrl &= (byte)~SID_CTRL_GATE;
-    SID_V1_CTRL = v1_ctrl;
-
-    v2_ctrl &= (byte)~SID_CTRL_GATE;
-    SID_V2_CTRL = v2_ctrl;
-
-    v3_ctrl &= (byte)~SID_CTRL_GATE;
-    SID_V3_CTRL = v3_ctrl;
-
-    // Reset step toggle
-    step_toggle = 0;
-}
-
-// Unified input: fills jx, jy, btn based on selected control mode
-// jx: -1 left, +1 right, 0 none
-// jy: -1 up,  +1 down,  0 none
-// btn: 1 when "button" is pressed, else 0
-void read_input(sbyte *jx, sbyte *jy, byte *btn)
-{
-    *jx = 0;
-    *jy = 0;
-    *btn = 0;
-
-    if (g_controlMode == CTRL_JOYSTICK)
-    {
-        // joystick only (port 2)
-        joy_poll(0);
-        *jx  = joyx[0];
-        *jy  = joyy[0];
-        *btn = joyb[0] ? 1 : 0;
-    }
-    else
-    {
-        // keyboard only
-        keyb_poll();
-
-        // WASD for direction
-        if (key_pressed(KSCAN_A))      *jx = -1;
-        else if (key_pressed(KSCAN_D)) *jx =  1;
-
-        if (key_pressed(KSCAN_W))      *jy = -1;
-        else if (key_pressed(KSCAN_S)) *jy =  1;
-
-        // Space as button
-        if (key_pressed(KSCAN_SPACE))  *btn = 1;
-    }
-}
-
-// Check for Joystick button
-static int is_fire_pressed(void) {
-    joy_poll(0);                // poll joystick port 2
-    return joyb[0];             // joystick 2 button pressed
-}
-
-// Direct Hardware Scan for Spacebar - doesn't rely on keyb_poll() isn't reliable with joystick
-static int is_space_pressed(void) {
-    *(volatile byte*)0xDC00 = 0x7F; 
-    return ((*(volatile byte*)0xDC01) & 0x10) == 0;
-}
 
-void select_controls(void)
-{
-    // Simple selection screen
-    screen_init();
-
-    // Large title using 5x5 block font 
-    draw_big_text(5, 3, "SNAKE", VCOL_YELLOW);
-    draw_big_text(5, 9, "64", VCOL_YELLOW);
+        // Player one is port 2 or the keyboard, player two port 1 (above)
+        // or the keyboard next to port 2
+        snake_players = 1;
 
-    // Copyright notice
-    screen_print_petscii(18, 9,  "CHRIS CHANDLER", VCOL_CYAN);
-    screen_print_petscii(21, 11, "COPYRIGHT", VCOL_WHITE);
-    screen_print_petscii(21, 13, "(C)  2026", VCOL_WHITE);
+        if (is_fire_pressed())
+        {
+            g_controlMode[0] = CTRL_JOYSTICK;
+            break;
+        }
 
-    // Control hints
-    screen_print_petscii(16,  16, "CONTROLS", VCOL_LT_RED);
-    screen_print_petscii(11,  18, "JOYSTICK ON PORT 2", VCOL_WHITE);
-    screen_print_petscii(13,  20, "KEYBOARD  WASD", VCOL_WHITE);
-    screen_print_petscii(4,   22, "PAUSE - FIRE BUTTON OR SPACE BAR", VCOL_WHITE);
+        if (is_space_pressed())
+        {
+            g_controlMode[0] = CTRL_KEYBOARD;
+            break;
+        }
 
-    // Wait for Joystick button or Spacebar
-    while (1)
-    {
-        vic_waitFrame();
+        snake_players = 2;
+        g_controlMode[0] = CTRL_JOYSTICK;
 
-        if (is_fire_pressed())
+        if (is_key_pressed(0xFE, 0x02))
         {
-            g_controlMode = CTRL_JOYSTICK;
+            g_controlMode[1] = CTRL_KEYBOARD;
             break;
         }
 
-        if (is_space_pressed())
+        // Nobody there, the computer plays one
+        if (ATTRACT_FRAMES && idle == ATTRACT_FRAMES)
         {
-            g_controlMode = CTRL_KEYBOARD;
+            snake_players = 1;
+            g_controlMode[0] = CTRL_AI;
+            TheGame.attract = 1;
             break;
         }
     }
 
-    screen_init();
+    // No disk I/O during play
+    hs_abort();
+
+    // Nothing left over from the last game's players
+    memset(input_jx, 0, sizeof(input_jx));
+    memset(input_jy, 0, sizeof(input_jy));
+    memset(input_btn, 0, sizeof(input_btn));
+
+    // Hand input sampling to the frame irq
+    frame_sampling = 1;
+    frame_resync();
 }
 
 
+// Stop sounds then show controls and restart
+void game_title(void)
+{
+    replay_end();
+    sound_stop_all();
+    overlay_hide();
+#ifdef SNAKE_ARENA
+    hal_scroll_off();
+#endif
+    select_controls();
+    random_init();
+    TheGame.level = 0;
+    game_state(GS_READY);
+}
+
 // Main game loop, invoked every vsync
 void game_loop(void)
 {
@@ -1096,11 +3924,21 @@ void game_loop(void)
 
 		case GS_PLAYING:
 		{
-			sbyte jx, jy;
-			byte  btn;
+			// Input sampled by the frame irq for the selected modes or
+			// played back, the button of either player pauses
+			if (!game_input(true))
+			{
+				game_title();
+				return;
+			}
+			byte  btn = game_btn;
 
-			// Read either joystick or keyboard depending on mode
-			read_input(&jx, &jy, &btn);
+			// A button ends the demo
+			if (TheGame.attract && btn)
+			{
+				game_title();
+				return;
+			}
 
 			// Pause button handling (edge detect)
 			if (btn && !TheGame.pauseButtonPrev)
@@ -1112,19 +3950,67 @@ void game_loop(void)
 			}
 			TheGame.pauseButtonPrev = btn;
 
-			// Movement control
-			snake_control(&TheGame.snake, jx, jy);
+			// Movement control, optionally taking a fresh turn early
+			for (byte p = 0; p < snake_players; p++)
+			{
+				snake_select(p);
+#ifdef SNAKE_EARLY_TURN
+				if (snake_control(game_jx[p], game_jy[p]))
+				{
+					word early = 0x100 - TURN_EARLY_FRAMES * TheGame.rate[p];
+					if (TheGame.move[p] < early)
+						TheGame.move[p] = early;
+				}
+#else
+				snake_control(game_jx[p], game_jy[p]);
+#endif
+			}
+
+			// At most one snake moves per frame, so two snakes never cost
+			// more than one. When both are due the other one waits a frame
+			// and goes first next time.
+			byte mover = 0xFF;
+			byte p = TheGame.next;
+			for (byte i = 0; i < snake_players; i++)
+			{
+				TheGame.move[p] += TheGame.rate[p];
+				if (TheGame.move[p] >= 0x100 && mover == 0xFF)
+					mover = p;
 
-			if (!--TheGame.count)
+				if (++p == snake_players)
+					p = 0;
+			}
+
+			tlm_game.frames++;
+
+			if (mover != 0xFF)
 			{
-				if (snake_advance(&TheGame.snake))
+				tlm_game.ticks++;
+				snake_select(mover);
+				if (snake_advance())
 				{
-					sound_death();
+					TheGame.crashed = mover;
 					game_state(GS_COLLIDE);
 				}
 				else
 				{
-					TheGame.count = snake_delay(TheGame.snake.length);
+					TheGame.move[mover] -= 0x100;
+					TheGame.rate[mover] = snake_rate(snake.length);
+					TheGame.next = mover + 1 == snake_players ? 0 : mover + 1;
+					if (snake.length > tlm_game.peak)
+						tlm_game.peak = snake.length;
+
+#if !defined(SNAKE_ARENA) && LEVEL_HEARTS
+					// Enough hearts, the next level. The computer only
+					// knows the open box, demo games stay there.
+					if (TheGame.hearts >= LEVEL_HEARTS && !TheGame.attract)
+					{
+						if (TheGame.level < 0xFF)
+							TheGame.level++;
+						event_post(EV_LEVEL, mover);
+						game_state(GS_READY);
+					}
+#endif
 				}
 			}
 			break;
@@ -1132,36 +4018,32 @@ void game_loop(void)
 
         case GS_COLLIDE:
         {
-            int flash_count = (int)(sizeof(FlashColors) / sizeof(FlashColors[0]));
-            int step = COLLIDE_FRAMES / flash_count;
-            int idx = 0;
-
-            /* Avoid division by zero and ensure idx is in range */
-            if (step <= 0) step = 1;
-            idx = (COLLIDE_FRAMES - TheGame.count) / step;
-            if (idx < 0) idx = 0;
-            if (idx >= flash_count) idx = flash_count - 1;
+            // Recolor the snake only on the frames where the palette moves on
+            if (!flash_timer)
+            {
+                if (flash_index < FLASH_COUNT)
+                    snake_flash(FlashColors[flash_index++]);
+                flash_timer = FLASH_STEP;
+            }
+            flash_timer--;
 
-            snake_flash(&TheGame.snake, FlashColors[idx]);
+            if (!replay_warp)
+                hs_update();
 
             if (!--TheGame.count)
-            {
-                // Stop sounds then show controls and restart
-                sound_stop_all();
-                select_controls();
-                random_init();
-                game_state(GS_READY);
-            }
+                game_title();
         }
         break;
 
 		case GS_PAUSED:
 		{
-			sbyte jx, jy;
-			byte  btn;
-
-			// Poll same input device while paused
-			read_input(&jx, &jy, &btn);
+			// Same input devices while paused
+			if (!game_input(false))
+			{
+				game_title();
+				return;
+			}
+			byte  btn = game_btn;
 
 			if (btn && !TheGame.pauseButtonPrev)
 			{
@@ -1175,21 +4057,62 @@ void game_loop(void)
 				TheGame.pauseButtonPrev = btn;
 			}
 
+			tlm_game.paused++;
 			pause_update();
 			break;
 		}
     }
 }
 
+// Zero page is not part of the program file, start it from known values
+void zp_init(void)
+{
+	memset(&snake, 0, sizeof(snake));
+	snake_id = 0;
+	snake_ring = snake_links[0];
+	fruit_pos = FRUIT_NONE;
+	occ_count = 0;
+	dq_count = 0;
+	ev_count = 0;
+	rng_state = 1;
+
+	for (byte v = 0; v < 3; v++)
+	{
+		sfx_pc[v] = NULL;
+		sfx_prio[v] = 0;
+	}
+}
+
+#ifndef SNAKE_HOST
 int main(void)
 {
+	zp_init();
+
 	// Screen color to black
 	vic.color_border = VCOL_BLACK;
 	vic.color_back = VCOL_BLACK;
 
+	// Screen pages in VIC bank 2
+	screen_pages_init();
+	overlay_init();
+	tlm_init();
+#ifndef SNAKE_ARENA
+	ai_init();
+#endif
+
+	// PAL or NTSC, before the irq takes over the raster
+	speed_init();
+
 	// Init sound
 	sound_init();
 
+	// Sound and input now run from the frame irq
+	frame_init();
+
+#ifdef SNAKE_PROFILE
+	prof_init();
+#endif
+
     // Ask player which input to use
     select_controls();
 	
@@ -1202,19 +4125,30 @@ int main(void)
 	// Forever
 	for(;;)
 	{
-		// Wait one vsync
-		vic_waitFrame();
-
-		// Update sound envelopes / gates
-		sound_update();
+		// Wait for the frame irq, sound and input ran there already
+		frame_next();
 
 		// One game loop iteration
+		PROF_BEGIN(PROF_GAME);
+#ifdef SNAKE_ARENA
+		// Window onto the arena first, while the beam is above the split
+		if (!replay_warp)
+			arena_scroll();
+#endif
 		game_loop();
+		PROF_END(PROF_GAME);
+
+        // What happened goes to the HUD, sound and statistics
+        PROF_BEGIN(PROF_HUD);
+        game_events();
+        PROF_END(PROF_HUD);
 
-        // Update HUD numeric values if changed
-        hud_update();
+#ifdef SNAKE_PROFILE
+        prof_frame();
+#endif
 	}
 
 	// Never reached
 	return 0;
 }
+#endif
@@ -0,0 +1,389 @@
+// © 2026 Christopher G Chandler
+// Licensed under the MIT License. See LICENSE file in the project root.
+//
+// Thin hardware layer for snake.c. The C64 build maps everything
+// straight onto the hardware and costs nothing. With SNAKE_HOST defined
+// the same game logic builds as a host program: memory and I/O are a
+// plain 64K array, the frame irq is run by whoever waits for a frame
+// and joystick input comes from hal_host_input(), which the host program
+// supplies.
+#ifndef SNAKE_HAL_H
+#define SNAKE_HAL_H
+
+#ifndef SNAKE_HOST
+
+#include <c64/joystick.h>
+#include <c64/vic.h>
+#include <c64/types.h>
+#include <c64/rasterirq.h>
+#include <c64/memmap.h>
+#include <c64/kernalio.h>
+
+// Absolute memory and I/O registers
+#define HAL_PTR(addr)   ((byte *)(addr))
+#define HAL_IO(addr)    (*(volatile byte *)(addr))
+
+// CIA1 port B, keyboard columns and the port 1 joystick
+#define HAL_CIA1_PRB    HAL_IO(0xDC01)
+
+// Hold off interrupts while the foreground changes state an irq shares
+inline void hal_irq_disable(void)
+{
+    __asm { sei }
+}
+
+inline void hal_irq_enable(void)
+{
+    __asm { cli }
+}
+
+// RAM instead of BASIC ROM at $A000-$BFFF, the KERNAL stays
+inline void hal_basic_off(void)
+{
+    mmap_set(MMAP_NO_BASIC);
+}
+
+// PAL frames have 312 raster lines, NTSC 262 or 263. Wait for the lines
+// past 255 and see how far they go.
+inline bool hal_video_ntsc(void)
+{
+    byte last = 0;
+
+    while (!(vic.ctrl1 & VIC_CTRL1_RST8))
+        ;
+    while (vic.ctrl1 & VIC_CTRL1_RST8)
+    {
+        byte r = vic.raster;
+        if (r > last)
+            last = r;
+    }
+
+    return last < 0x20;
+}
+
+// Raster irq at a fixed line calling the game's frame handler
+__interrupt void frame_irq(void);
+
+static RIRQCode hal_frame_irq_code;
+
+#ifdef SNAKE_ARENA
+// Text screen scroll values, the HUD row above the split gets them back
+// from the frame irq on every frame
+#define HAL_CTRL1_TEXT  (VIC_CTRL1_DEN | VIC_CTRL1_RSEL | 3)
+#define HAL_CTRL2_TEXT  VIC_CTRL2_CSEL
+#define HAL_CTRL1_BLANK (VIC_CTRL1_ECM | VIC_CTRL1_BMM)   // invalid mode, black
+
+static RIRQCode hal_split_code, hal_window_code;
+#endif
+
+inline void hal_frame_irq_start(byte line)
+{
+    rirq_init(true);
+
+#ifdef SNAKE_ARENA
+    rirq_build(&hal_frame_irq_code, 3);
+    rirq_write(&hal_frame_irq_code, 0, &vic.ctrl1, HAL_CTRL1_TEXT);
+    rirq_write(&hal_frame_irq_code, 1, &vic.ctrl2, HAL_CTRL2_TEXT);
+    rirq_call(&hal_frame_irq_code, 2, frame_irq);
+#else
+    rirq_build(&hal_frame_irq_code, 1);
+    rirq_call(&hal_frame_irq_code, 0, frame_irq);
+#endif
+    rirq_set(0, line, &hal_frame_irq_code);
+
+    rirq_sort();
+    rirq_start();
+}
+
+#ifdef SNAKE_ARENA
+// Scroll split under the HUD row. From the split line on the playfield
+// has its own scroll registers, blanked down to the window line so rows
+// moving in at the top never show half drawn. Until hal_scroll_set()
+// both keep the text screen values.
+inline void hal_scroll_start(byte split, byte window)
+{
+    rirq_build(&hal_split_code, 2);
+    rirq_write(&hal_split_code, 0, &vic.ctrl1, HAL_CTRL1_TEXT);
+    rirq_write(&hal_split_code, 1, &vic.ctrl2, HAL_CTRL2_TEXT);
+    rirq_set(1, split, &hal_split_code);
+
+    rirq_build(&hal_window_code, 1);
+    rirq_write(&hal_window_code, 0, &vic.ctrl1, HAL_CTRL1_TEXT);
+    rirq_set(2, window, &hal_window_code);
+
+    rirq_sort();
+}
+
+// Playfield $D011/$D016 from the next frame on, split moves the first
+// write for the one fine scroll that would match its own line
+inline void hal_scroll_set(byte split, byte ctrl1, byte ctrl2)
+{
+    rirq_data(&hal_split_code, 0, ctrl1 | HAL_CTRL1_BLANK);
+    rirq_data(&hal_split_code, 1, ctrl2);
+    rirq_data(&hal_window_code, 0, ctrl1);
+    rirq_move(1, split);
+    rirq_sort();
+}
+
+// The whole screen as plain text again
+inline void hal_scroll_off(void)
+{
+    rirq_data(&hal_split_code, 0, HAL_CTRL1_TEXT);
+    rirq_data(&hal_split_code, 1, HAL_CTRL2_TEXT);
+    rirq_data(&hal_window_code, 0, HAL_CTRL1_TEXT);
+}
+#endif
+
+// Disk files through the KERNAL, each call moves only the bytes asked
+// for. A drive that isn't there answers device not present right away.
+inline bool hal_disk_open(byte fnum, byte device, byte channel, const char * name)
+{
+    krnio_setnam(name);
+    if (krnio_open(fnum, device, channel) && !(krnio_status() & KRNIO_NODEVICE))
+        return true;
+
+    krnio_close(fnum);
+    return false;
+}
+
+inline void hal_disk_close(byte fnum)
+{
+    krnio_close(fnum);
+}
+
+// Bytes read, fewer than asked at the end of the file
+inline byte hal_disk_read(byte fnum, byte * data, byte n)
+{
+    int r = krnio_read(fnum, (char *)data, n);
+    return r > 0 ? r : 0;
+}
+
+inline bool hal_disk_write(byte fnum, const byte * data, byte n)
+{
+    return krnio_write(fnum, (const char *)data, n) == n;
+}
+
+// Drive the program was loaded from, 8 when it came from elsewhere
+inline byte hal_disk_device(void)
+{
+    byte d = HAL_IO(0xBA);
+    return d >= 8 && d < 31 ? d : 8;
+}
+
+// Called while busy waiting for the frame irq
+#define hal_idle()
+
+#else
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+typedef uint8_t     byte;
+typedef int8_t      sbyte;
+typedef uint16_t    word;
+typedef int16_t     sword;
+
+// Oscar64 storage and calling qualifiers
+#define __interrupt
+#define __noinline
+#define __zeropage
+
+enum
+{
+    VCOL_BLACK, VCOL_WHITE, VCOL_RED, VCOL_CYAN,
+    VCOL_PURPLE, VCOL_GREEN, VCOL_BLUE, VCOL_YELLOW,
+    VCOL_ORANGE, VCOL_BROWN, VCOL_LT_RED, VCOL_DARK_GREY,
+    VCOL_MED_GREY, VCOL_LT_GREEN, VCOL_LT_BLUE, VCOL_LT_GREY
+};
+
+// The whole C64 address space, RAM and I/O alike
+static byte hal_mem[0x10000];
+
+#define HAL_PTR(addr)   (hal_mem + (addr))
+#define HAL_IO(addr)    (hal_mem[addr])
+
+// VIC registers the game touches by name
+static struct
+{
+    byte    color_border;
+    byte    color_back;
+} vic __attribute__((unused));
+
+// Joystick, filled in by hal_host_input()
+static sbyte joyx[2], joyy[2];
+static bool  joyb[2];
+
+// Keyboard matrix on CIA1. Row r holds the columns down in the row PRA
+// bit r selects, the port 1 joystick pulls its lines of port B low
+// whatever row is selected, the same as on the C64.
+static byte hal_host_keys[8];
+static byte hal_host_port1;
+
+static inline byte * hal_host_prb(void)
+{
+    byte low = hal_host_port1;
+    for (byte r = 0; r < 8; r++)
+        if (!(hal_mem[0xDC00] & (1 << r)))
+            low |= hal_host_keys[r];
+    hal_mem[0xDC01] = (byte)~low;
+    return hal_mem + 0xDC01;
+}
+
+#define HAL_CIA1_PRB    (*hal_host_prb())
+
+void hal_host_input(byte n);
+
+static inline void joy_poll(byte n)
+{
+    hal_host_input(n);
+
+    // Port 1 up, down, left, right and fire on PB0-PB4
+    if (n)
+        hal_host_port1 = (joyy[1] < 0 ? 0x01 : 0) | (joyy[1] > 0 ? 0x02 : 0) |
+                         (joyx[1] < 0 ? 0x04 : 0) | (joyx[1] > 0 ? 0x08 : 0) |
+                         (joyb[1] ? 0x10 : 0);
+}
+
+static inline void hal_irq_disable(void)
+{
+}
+
+static inline void hal_irq_enable(void)
+{
+}
+
+static inline void hal_basic_off(void)
+{
+}
+
+// Host runs count as PAL
+static inline bool hal_video_ntsc(void)
+{
+    return false;
+}
+
+// There is no raster, the frame irq runs whenever the game waits for it
+void frame_irq(void);
+
+static inline void hal_frame_irq_start(byte line)
+{
+    (void)line;
+}
+
+// No raster split either, the scroll registers just hold the values
+static inline void hal_scroll_start(byte split, byte window)
+{
+    (void)split;
+    (void)window;
+}
+
+static inline void hal_scroll_set(byte split, byte ctrl1, byte ctrl2)
+{
+    (void)split;
+    HAL_IO(0xD011) = ctrl1;
+    HAL_IO(0xD016) = ctrl2;
+}
+
+static inline void hal_scroll_off(void)
+{
+}
+
+// A drive with room for one small file, kept in memory. It takes the
+// same open names the 1541 does for what the game needs: "S0:name" on
+// the command channel scratches, "name,S,R" reads and "name,S,W" writes
+// a new file, an existing one stays as it is. Clear hal_host_drive and
+// no drive answers.
+#define HAL_DISK_FILE   256
+
+static bool hal_host_drive = true;
+static char hal_disk_name[17];
+static byte hal_disk_file[HAL_DISK_FILE];
+static word hal_disk_size;
+static bool hal_disk_exists;
+static word hal_disk_pos;
+static char hal_disk_mode;      // 'R' or 'W' while open, else 0
+
+// Length of the file name in an open name, up to the first comma
+static word hal_disk_namelen(const char * name)
+{
+    word n = 0;
+    while (name[n] && name[n] != ',')
+        n++;
+    return n;
+}
+
+static inline bool hal_disk_open(byte fnum, byte device, byte channel, const char * name)
+{
+    (void)fnum;
+    (void)device;
+
+    if (!hal_host_drive)
+        return false;
+
+    if (channel == 15)
+    {
+        if (name[0] == 'S' && name[1] == '0' && name[2] == ':' && !strcmp(name + 3, hal_disk_name))
+            hal_disk_exists = false;
+        return true;
+    }
+
+    word n = hal_disk_namelen(name);
+    bool same = n == strlen(hal_disk_name) && !memcmp(name, hal_disk_name, n);
+    char mode = name[n] ? name[n + 3] : 'R';
+
+    hal_disk_mode = 0;
+    hal_disk_pos = 0;
+    if (mode == 'R' && same && hal_disk_exists)
+        hal_disk_mode = 'R';
+    else if (mode == 'W' && !(same && hal_disk_exists) && n < sizeof(hal_disk_name))
+    {
+        memcpy(hal_disk_name, name, n);
+        hal_disk_name[n] = 0;
+        hal_disk_exists = true;
+        hal_disk_size = 0;
+        hal_disk_mode = 'W';
+    }
+    return true;
+}
+
+static inline void hal_disk_close(byte fnum)
+{
+    (void)fnum;
+    hal_disk_mode = 0;
+}
+
+static inline byte hal_disk_read(byte fnum, byte * data, byte n)
+{
+    (void)fnum;
+
+    if (hal_disk_mode != 'R')
+        return 0;
+    if (n > hal_disk_size - hal_disk_pos)
+        n = hal_disk_size - hal_disk_pos;
+    memcpy(data, hal_disk_file + hal_disk_pos, n);
+    hal_disk_pos += n;
+    return n;
+}
+
+static inline bool hal_disk_write(byte fnum, const byte * data, byte n)
+{
+    (void)fnum;
+
+    if (hal_disk_mode != 'W' || hal_disk_size + n > HAL_DISK_FILE)
+        return false;
+    memcpy(hal_disk_file + hal_disk_size, data, n);
+    hal_disk_size += n;
+    return true;
+}
+
+static inline byte hal_disk_device(void)
+{
+    return 8;
+}
+
+#define hal_idle()      frame_irq()
+
+#endif
+
+#endif
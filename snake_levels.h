@@ -0,0 +1,34 @@
+// Level layouts, generated by tools/mklevels.c with levels.bat.
+// Do not edit, change LevelLayouts in snake.c instead.
+
+#define LEVEL_COUNT  4
+
+static const byte LevelRle[] = {
+	// level 0
+	0x0f, 0x00,
+	// level 1
+	0x0f, 0x78, 0x9a, 0x7f, 0x21, 0x81, 0x20, 0x81, 0x04, 0x81, 0x20, 0x81,
+	0x04, 0x81, 0x20, 0x81, 0x04, 0x81, 0x20, 0x81, 0x04, 0x81, 0x20, 0x81,
+	0x04, 0x81, 0x20, 0x81, 0x7f, 0x21, 0x9a, 0x00,
+	// level 2
+	0x09, 0x50, 0x82, 0x05, 0x82, 0x05, 0x82, 0x05, 0x82, 0x05, 0x82, 0x08,
+	0x82, 0x05, 0x82, 0x05, 0x82, 0x05, 0x82, 0x05, 0x82, 0x7a, 0x82, 0x05,
+	0x82, 0x05, 0x82, 0x05, 0x82, 0x05, 0x82, 0x08, 0x82, 0x05, 0x82, 0x05,
+	0x82, 0x05, 0x82, 0x05, 0x82, 0x7f, 0x21, 0x82, 0x05, 0x82, 0x05, 0x82,
+	0x05, 0x82, 0x05, 0x82, 0x08, 0x82, 0x05, 0x82, 0x05, 0x82, 0x05, 0x82,
+	0x05, 0x82, 0x7a, 0x82, 0x05, 0x82, 0x05, 0x82, 0x05, 0x82, 0x05, 0x82,
+	0x08, 0x82, 0x05, 0x82, 0x05, 0x82, 0x05, 0x82, 0x05, 0x82, 0x00,
+	// level 3
+	0x04, 0x76, 0x8d, 0x04, 0x8d, 0x08, 0x81, 0x1c, 0x81, 0x08, 0x81, 0x1c,
+	0x81, 0x08, 0x81, 0x1c, 0x81, 0x08, 0x81, 0x1c, 0x81, 0x08, 0x81, 0x1c,
+	0x81, 0x7f, 0x21, 0x81, 0x1c, 0x81, 0x08, 0x81, 0x1c, 0x81, 0x08, 0x81,
+	0x1c, 0x81, 0x08, 0x81, 0x1c, 0x81, 0x08, 0x81, 0x1c, 0x81, 0x08, 0x8d,
+	0x04, 0x8d, 0x00,
+};
+
+static const byte * const Levels[LEVEL_COUNT] = {
+	LevelRle + 0,
+	LevelRle + 2,
+	LevelRle + 34,
+	LevelRle + 117
+};
@@ -0,0 +1,56 @@
+// Title screen images, generated by tools/mktitle.c with title.bat.
+// Do not edit, change title_draw() in snake.c instead.
+
+static const byte TitleScreenRle[] = {
+	0x28, 0x20, 0x29, 0xa0, 0x26, 0x20, 0x02, 0xa0, 0x04, 0x20, 0x05, 0xa0, 0x01, 0x20, 0x01, 0xa0,
+	0x03, 0x20, 0x01, 0xa0, 0x02, 0x20, 0x03, 0xa0, 0x02, 0x20, 0x01, 0xa0, 0x03, 0x20, 0x01, 0xa0,
+	0x01, 0x20, 0x05, 0xa0, 0x05, 0x20, 0x02, 0xa0, 0x04, 0x20, 0x01, 0xa0, 0x05, 0x20, 0x02, 0xa0,
+	0x02, 0x20, 0x01, 0xa0, 0x01, 0x20, 0x01, 0xa0, 0x03, 0x20, 0x01, 0xa0, 0x01, 0x20, 0x01, 0xa0,
+	0x02, 0x20, 0x01, 0xa0, 0x02, 0x20, 0x01, 0xa0, 0x09, 0x20, 0x02, 0xa0, 0x04, 0x20, 0x05, 0xa0,
+	0x01, 0x20, 0x01, 0xa0, 0x01, 0x20, 0x01, 0xa0, 0x01, 0x20, 0x01, 0xa0, 0x01, 0x20, 0x05, 0xa0,
+	0x01, 0x20, 0x03, 0xa0, 0x03, 0x20, 0x04, 0xa0, 0x06, 0x20, 0x02, 0xa0, 0x08, 0x20, 0x01, 0xa0,
+	0x01, 0x20, 0x01, 0xa0, 0x02, 0x20, 0x02, 0xa0, 0x01, 0x20, 0x01, 0xa0, 0x03, 0x20, 0x01, 0xa0,
+	0x01, 0x20, 0x01, 0xa0, 0x02, 0x20, 0x01, 0xa0, 0x02, 0x20, 0x01, 0xa0, 0x09, 0x20, 0x02, 0xa0,
+	0x04, 0x20, 0x05, 0xa0, 0x01, 0x20, 0x01, 0xa0, 0x03, 0x20, 0x01, 0xa0, 0x01, 0x20, 0x01, 0xa0,
+	0x03, 0x20, 0x01, 0xa0, 0x01, 0x20, 0x01, 0xa0, 0x03, 0x20, 0x01, 0xa0, 0x01, 0x20, 0x05, 0xa0,
+	0x05, 0x20, 0x02, 0xa0, 0x26, 0x20, 0x02, 0xa0, 0x04, 0x20, 0x05, 0xa0, 0x01, 0x20, 0x01, 0xa0,
+	0x02, 0x20, 0x01, 0xa0, 0x03, 0x20, 0x01, 0x03, 0x01, 0x08, 0x01, 0x12, 0x01, 0x09, 0x01, 0x13,
+	0x01, 0x20, 0x01, 0x03, 0x01, 0x08, 0x01, 0x01, 0x01, 0x0e, 0x01, 0x04, 0x01, 0x0c, 0x01, 0x05,
+	0x01, 0x12, 0x07, 0x20, 0x02, 0xa0, 0x04, 0x20, 0x01, 0xa0, 0x05, 0x20, 0x01, 0xa0, 0x02, 0x20,
+	0x01, 0xa0, 0x18, 0x20, 0x02, 0xa0, 0x04, 0x20, 0x05, 0xa0, 0x01, 0x20, 0x05, 0xa0, 0x05, 0x20,
+	0x01, 0x03, 0x01, 0x0f, 0x01, 0x10, 0x01, 0x19, 0x01, 0x12, 0x01, 0x09, 0x01, 0x07, 0x01, 0x08,
+	0x01, 0x14, 0x09, 0x20, 0x02, 0xa0, 0x04, 0x20, 0x01, 0xa0, 0x03, 0x20, 0x01, 0xa0, 0x04, 0x20,
+	0x01, 0xa0, 0x18, 0x20, 0x02, 0xa0, 0x04, 0x20, 0x05, 0xa0, 0x04, 0x20, 0x01, 0xa0, 0x06, 0x20,
+	0x01, 0x28, 0x01, 0x03, 0x01, 0x29, 0x02, 0x20, 0x01, 0x32, 0x01, 0x30, 0x01, 0x32, 0x01, 0x36,
+	0x09, 0x20, 0x02, 0xa0, 0x26, 0x20, 0x02, 0xa0, 0x26, 0x20, 0x02, 0xa0, 0x0f, 0x20, 0x01, 0x03,
+	0x01, 0x0f, 0x01, 0x0e, 0x01, 0x14, 0x01, 0x12, 0x01, 0x0f, 0x01, 0x0c, 0x01, 0x13, 0x0f, 0x20,
+	0x02, 0xa0, 0x26, 0x20, 0x02, 0xa0, 0x0a, 0x20, 0x01, 0x0a, 0x01, 0x0f, 0x01, 0x19, 0x01, 0x13,
+	0x01, 0x14, 0x01, 0x09, 0x01, 0x03, 0x01, 0x0b, 0x01, 0x20, 0x01, 0x0f, 0x01, 0x0e, 0x01, 0x20,
+	0x01, 0x10, 0x01, 0x0f, 0x01, 0x12, 0x01, 0x14, 0x01, 0x20, 0x01, 0x32, 0x0a, 0x20, 0x02, 0xa0,
+	0x0c, 0x20, 0x01, 0x0b, 0x01, 0x05, 0x01, 0x19, 0x01, 0x02, 0x01, 0x0f, 0x01, 0x01, 0x01, 0x12,
+	0x01, 0x04, 0x02, 0x20, 0x01, 0x17, 0x01, 0x01, 0x01, 0x13, 0x01, 0x04, 0x0c, 0x20, 0x02, 0xa0,
+	0x02, 0x20, 0x01, 0x32, 0x01, 0x20, 0x01, 0x10, 0x01, 0x0c, 0x01, 0x01, 0x01, 0x19, 0x01, 0x05,
+	0x01, 0x12, 0x01, 0x13, 0x01, 0x20, 0x01, 0x2d, 0x01, 0x20, 0x01, 0x10, 0x01, 0x0f, 0x01, 0x12,
+	0x01, 0x14, 0x01, 0x20, 0x01, 0x31, 0x01, 0x20, 0x01, 0x06, 0x01, 0x09, 0x01, 0x12, 0x01, 0x05,
+	0x01, 0x20, 0x01, 0x0f, 0x01, 0x12, 0x01, 0x20, 0x01, 0x12, 0x01, 0x05, 0x01, 0x14, 0x01, 0x15,
+	0x01, 0x12, 0x01, 0x0e, 0x03, 0x20, 0x02, 0xa0, 0x03, 0x20, 0x01, 0x10, 0x01, 0x01, 0x01, 0x15,
+	0x01, 0x13, 0x01, 0x05, 0x01, 0x20, 0x01, 0x2d, 0x01, 0x20, 0x01, 0x06, 0x01, 0x09, 0x01, 0x12,
+	0x01, 0x05, 0x01, 0x20, 0x01, 0x02, 0x01, 0x15, 0x02, 0x14, 0x01, 0x0f, 0x01, 0x0e, 0x01, 0x20,
+	0x01, 0x0f, 0x01, 0x12, 0x01, 0x20, 0x01, 0x13, 0x01, 0x10, 0x01, 0x01, 0x01, 0x03, 0x01, 0x05,
+	0x01, 0x20, 0x01, 0x02, 0x01, 0x01, 0x01, 0x12, 0x03, 0x20, 0x02, 0xa0, 0x03, 0x20, 0x01, 0x12,
+	0x01, 0x20, 0x01, 0x12, 0x01, 0x05, 0x01, 0x10, 0x01, 0x0c, 0x01, 0x01, 0x01, 0x19, 0x01, 0x2c,
+	0x01, 0x20, 0x01, 0x06, 0x01, 0x20, 0x01, 0x09, 0x01, 0x0e, 0x01, 0x20, 0x01, 0x17, 0x01, 0x01,
+	0x01, 0x12, 0x01, 0x10, 0x01, 0x2c, 0x01, 0x20, 0x01, 0x14, 0x01, 0x20, 0x01, 0x07, 0x01, 0x01,
+	0x01, 0x0d, 0x01, 0x05, 0x01, 0x20, 0x01, 0x0c, 0x01, 0x0f, 0x01, 0x07, 0x04, 0x20, 0x02, 0xa0,
+	0x08, 0x20, 0x01, 0x13, 0x01, 0x10, 0x02, 0x05, 0x01, 0x04, 0x01, 0x20, 0x01, 0x31, 0x01, 0x2d,
+	0x01, 0x33, 0x15, 0x20, 0x29, 0xa0, 0x00
+};
+
+static const byte TitleColorRle[] = {
+	0x28, 0x00, 0x55, 0x0f, 0x22, 0x07, 0x06, 0x0f, 0x22, 0x07, 0x06, 0x0f, 0x22, 0x07, 0x0a, 0x0f,
+	0x1e, 0x07, 0x06, 0x0f, 0x22, 0x07, 0x2e, 0x0f, 0x0d, 0x07, 0x15, 0x03, 0x06, 0x0f, 0x22, 0x07,
+	0x06, 0x0f, 0x10, 0x07, 0x12, 0x01, 0x06, 0x0f, 0x22, 0x07, 0x06, 0x0f, 0x10, 0x07, 0x12, 0x01,
+	0x61, 0x0f, 0x17, 0x0a, 0x34, 0x0f, 0x1c, 0x01, 0x0e, 0x0f, 0x1a, 0x01, 0x04, 0x0f, 0x24, 0x01,
+	0x05, 0x0f, 0x23, 0x01, 0x05, 0x0f, 0x23, 0x01, 0x0a, 0x0f, 0x1e, 0x0a, 0x29, 0x0f, 0x00
+};
+
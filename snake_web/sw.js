@@ -0,0 +1,88 @@
+// © 2026 Christopher G Chandler
+// Licensed under the MIT License. See LICENSE file in the project root.
+//
+// Service worker for the web player. The emulator and the program are
+// kept in Cache Storage so repeat visits start without downloading them
+// again. Bump CACHE_VERSION whenever one of the assets changes,
+// the new worker then fetches them once and drops the old cache.
+
+var CACHE_VERSION = 'snake-v2';
+
+// Large assets served cache first
+var ASSETS = [
+    'js/x64.js',
+    'snake_packed.prg'
+];
+
+// Cached the same way when the server has them
+var OPTIONAL_ASSETS = [
+    'snake.vsf'
+];
+
+function isAsset(url) {
+    var scope = new URL(self.registration.scope);
+    var all = ASSETS.concat(OPTIONAL_ASSETS);
+    for (var i = 0; i < all.length; i++) {
+        if (url.href === new URL(all[i], scope).href) {
+            return true;
+        }
+    }
+    return false;
+}
+
+self.addEventListener('install', function (event) {
+    // Prefetch while the start overlay is showing
+    event.waitUntil(
+        caches.open(CACHE_VERSION)
+            .then(function (cache) {
+                // A missing optional asset must not fail the install
+                return Promise.all([cache.addAll(ASSETS)].concat(
+                    OPTIONAL_ASSETS.map(function (asset) {
+                        return cache.add(asset).catch(function () {});
+                    })));
+            })
+            .then(function () {
+                return self.skipWaiting();
+            })
+    );
+});
+
+self.addEventListener('activate', function (event) {
+    event.waitUntil(
+        caches.keys()
+            .then(function (keys) {
+                return Promise.all(keys
+                    .filter(function (key) { return key !== CACHE_VERSION; })
+                    .map(function (key) { return caches.delete(key); }));
+            })
+            .then(function () {
+                return self.clients.claim();
+            })
+    );
+});
+
+self.addEventListener('fetch', function (event) {
+    var url = new URL(event.request.url);
+
+    // The page and everything else go to the network as before
+    if (event.request.method !== 'GET' || !isAsset(url)) {
+        return;
+    }
+
+    event.respondWith(
+        caches.open(CACHE_VERSION).then(function (cache) {
+            return cache.match(event.request).then(function (cached) {
+                if (cached) {
+                    return cached;
+                }
+
+                return fetch(event.request).then(function (response) {
+                    if (response.ok) {
+                        cache.put(event.request, response.clone());
+                    }
+                    return response;
+                });
+            });
+        })
+    );
+});
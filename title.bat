@@ -0,0 +1,2 @@
+gcc -O2 -std=gnu99 -fgnu89-inline -o mktitle tools/mktitle.c
+mktitle > snake_title.h
\ No newline at end of file
@@ -0,0 +1,142 @@
+// © 2026 Christopher G Chandler
+// Licensed under the MIT License. See LICENSE file in the project root.
+//
+// Packs the level layouts in snake.c into the runs of free and wall
+// cells level_load() unpacks, the snake_levels.h the game build
+// includes. Layouts that would trap a snake at the start or cut off
+// part of the playfield are refused.
+//
+//   mklevels > snake_levels.h
+#define SNAKE_HOST
+#define SNAKE_LEVEL_TOOL
+#include "../snake.c"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+void hal_host_input(byte n)
+{
+	(void)n;
+}
+
+static bool wall(unsigned l, int x, int y)
+{
+	return LevelLayouts[l].rows[y][x] == '#';
+}
+
+static void fail(unsigned l, const char * what)
+{
+	fprintf(stderr, "level %u: %s\n", l, what);
+	exit(1);
+}
+
+// Start cells and the cells ahead of them free, every free cell reachable
+static void check(unsigned l)
+{
+	for (int y = 0; y < FIELD_H; y++)
+		if (strlen(LevelLayouts[l].rows[y]) != FIELD_W)
+			fail(l, "row is not as wide as the playfield");
+
+	for (int n = 0; n < SNAKE_PLAYERS; n++)
+		for (int i = 0; i <= n; i++)
+		{
+			const SnakeStart * st = &SnakeStarts[n][i];
+			int x = st->head % MAP_W - FIELD_X0, y = st->head / MAP_W - FIELD_Y0;
+			for (int k = 0; k < 3; k++)
+				if (wall(l, x + k * st->dx, y))
+					fail(l, "wall on or in front of a snake start");
+		}
+
+	static bool seen[FIELD_H][FIELD_W];
+	static int  stack[FIELD_CELLS];
+	int sp = 0, found = 0, open = 0;
+
+	memset(seen, 0, sizeof(seen));
+	for (int y = 0; y < FIELD_H; y++)
+		for (int x = 0; x < FIELD_W; x++)
+			if (!wall(l, x, y))
+			{
+				if (!open++)
+				{
+					seen[y][x] = true;
+					stack[sp++] = y * FIELD_W + x;
+				}
+			}
+
+	while (sp)
+	{
+		int c = stack[--sp], x = c % FIELD_W, y = c / FIELD_W;
+		static const int d[4][2] = { { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 } };
+
+		found++;
+		for (int i = 0; i < 4; i++)
+		{
+			int nx = x + d[i][0], ny = y + d[i][1];
+			if (nx >= 0 && nx < FIELD_W && ny >= 0 && ny < FIELD_H && !seen[ny][nx] && !wall(l, nx, ny))
+			{
+				seen[ny][nx] = true;
+				stack[sp++] = ny * FIELD_W + nx;
+			}
+		}
+	}
+
+	if (found != open)
+		fail(l, "walls cut off part of the playfield");
+}
+
+// Runs of one level, up to its last wall
+static unsigned emit(unsigned l)
+{
+	byte     data[2 * FIELD_CELLS + 2];
+	unsigned size = 0, last = 0;
+
+	data[size++] = LevelLayouts[l].color;
+	for (unsigned c = 0; c < FIELD_CELLS; )
+	{
+		bool     w = wall(l, c % FIELD_W, c / FIELD_W);
+		unsigned n = 1;
+		while (c + n < FIELD_CELLS && n < LEVEL_RUN_MAX && wall(l, (c + n) % FIELD_W, (c + n) / FIELD_W) == w)
+			n++;
+
+		data[size++] = (w ? LEVEL_RUN_WALL : 0) | n;
+		if (w)
+			last = size;
+		c += n;
+	}
+	size = last ? last : 1;
+	data[size++] = 0;
+
+	printf("\t// level %u\n", l);
+	for (unsigned i = 0; i < size; i++)
+		printf("%s0x%02x,%s", i % 12 ? " " : "\t", data[i], i % 12 == 11 || i == size - 1 ? "\n" : "");
+
+	return size;
+}
+
+int main(void)
+{
+	unsigned start[LEVEL_LAYOUTS], size = 0;
+
+	for (unsigned l = 0; l < LEVEL_LAYOUTS; l++)
+		check(l);
+
+	printf("// Level layouts, generated by tools/mklevels.c with levels.bat.\n");
+	printf("// Do not edit, change LevelLayouts in snake.c instead.\n\n");
+	printf("#define LEVEL_COUNT  %u\n\n", (unsigned)LEVEL_LAYOUTS);
+
+	printf("static const byte LevelRle[] = {\n");
+	for (unsigned l = 0; l < LEVEL_LAYOUTS; l++)
+	{
+		start[l] = size;
+		size += emit(l);
+	}
+	printf("};\n\n");
+
+	printf("static const byte * const Levels[LEVEL_COUNT] = {\n");
+	for (unsigned l = 0; l < LEVEL_LAYOUTS; l++)
+		printf("\tLevelRle + %u%s\n", start[l], l + 1 < LEVEL_LAYOUTS ? "," : "");
+	printf("};\n");
+
+	fprintf(stderr, "%u levels, %u bytes\n", (unsigned)LEVEL_LAYOUTS, size);
+	return 0;
+}
@@ -0,0 +1,66 @@
+// © 2026 Christopher G Chandler
+// Licensed under the MIT License. See LICENSE file in the project root.
+//
+// Renders the static title screen with the game's own title_draw() on
+// the host and writes it as run length images of screen codes and
+// colors, the snake_title.h the game build includes.
+//
+//   mktitle > snake_title.h
+#define SNAKE_HOST
+#define SNAKE_TITLE_TOOL
+#include "../snake.c"
+
+#include <stdio.h>
+
+void hal_host_input(byte n)
+{
+	(void)n;
+}
+
+// Pairs of count and value, a zero count ends the image
+static unsigned emit(const char * name, const byte * data)
+{
+	unsigned size = 0, col = 0;
+
+	printf("static const byte %s[] = {\n", name);
+	for (unsigned i = 0; i < 1000; )
+	{
+		byte     v = data[i];
+		unsigned n = 1;
+		while (i + n < 1000 && n < 255 && data[i + n] == v)
+			n++;
+
+		printf("%s0x%02x, 0x%02x,", col ? " " : "\t", n, v);
+		if (++col == 8)
+		{
+			printf("\n");
+			col = 0;
+		}
+
+		size += 2;
+		i += n;
+	}
+	printf("%s0x00\n};\n\n", col ? " " : "\t");
+
+	return size + 1;
+}
+
+int main(void)
+{
+	zp_init();
+	title_draw();
+
+	// Colors under blanks never show, they continue the run before them
+	byte color[1000];
+	for (unsigned i = 0; i < 1000; i++)
+		color[i] = Screen[i] == ' ' && i ? color[i - 1] : Color[i];
+
+	printf("// Title screen images, generated by tools/mktitle.c with title.bat.\n");
+	printf("// Do not edit, change title_draw() in snake.c instead.\n\n");
+
+	unsigned s = emit("TitleScreenRle", Screen);
+	unsigned c = emit("TitleColorRle", color);
+
+	fprintf(stderr, "title screen %u bytes, colors %u bytes\n", s, c);
+	return 0;
+}